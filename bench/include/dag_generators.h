@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+using edge = std::pair<std::uint32_t, std::uint32_t>;
+using edges_t = std::vector<edge>;
+
+/// \brief splitmix64, unlike the std distributions its output is the same
+/// on every platform, so the generated workloads are reproducible
+class random {
+public:
+    explicit random(std::uint64_t seed)
+        : m_state(seed)
+    {
+    }
+
+    std::uint64_t next() noexcept
+    {
+        std::uint64_t z = (m_state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    /// \brief uniform in [0, n)
+    std::uint32_t below(std::uint32_t n) noexcept
+    {
+        return static_cast<std::uint32_t>(((next() >> 32) * n) >> 32);
+    }
+
+private:
+    std::uint64_t m_state;
+};
+
+/// \brief 0 -> 1 -> ... -> num_edges, depth is num_edges + 1
+inline edges_t make_chain(size_t num_edges)
+{
+    edges_t res;
+    res.reserve(num_edges);
+    for (std::uint32_t i = 0; i < num_edges; ++i) {
+        res.emplace_back(i, i + 1);
+    }
+    return res;
+}
+
+/// \brief one root fanning out to num_edges / 2 jobs that fan in to a
+/// single sink
+inline edges_t make_fan(size_t num_edges)
+{
+    const auto width
+        = static_cast<std::uint32_t>(std::max<size_t>(1, num_edges / 2));
+    edges_t res;
+    res.reserve(2 * width);
+    for (std::uint32_t i = 1; i <= width; ++i) {
+        res.emplace_back(0, i);
+        res.emplace_back(i, width + 1);
+    }
+    return res;
+}
+
+/// \brief layers of equal width, every job depends on degree random jobs
+/// of the previous layer
+inline edges_t make_layered(size_t num_edges, std::uint32_t degree = 4,
+    std::uint32_t layers = 64, std::uint64_t seed = 1)
+{
+    random rnd(seed);
+    const auto width = static_cast<std::uint32_t>(
+        std::max<size_t>(degree, num_edges / degree / (layers - 1)));
+    edges_t res;
+    res.reserve(num_edges);
+    for (std::uint32_t l = 1; l < layers && res.size() < num_edges; ++l) {
+        for (std::uint32_t i = 0; i < width && res.size() < num_edges; ++i) {
+            const auto to = l * width + i;
+            for (std::uint32_t d = 0; d < degree && res.size() < num_edges;
+                 ++d) {
+                res.emplace_back((l - 1) * width + rnd.below(width), to);
+            }
+        }
+    }
+    return res;
+}
+
+/// \brief preferential attachment, every new job depends on degree earlier
+/// jobs chosen proportionally to their degree, which gives a power law
+/// degree distribution
+inline edges_t make_power_law(
+    size_t num_edges, std::uint32_t degree = 4, std::uint64_t seed = 1)
+{
+    random rnd(seed);
+    edges_t res;
+    res.reserve(num_edges);
+    // every end point of every edge once, sampling it is sampling by degree
+    std::vector<std::uint32_t> endpoints{ 0 };
+    endpoints.reserve(2 * num_edges + 1);
+    for (std::uint32_t v = 1; res.size() < num_edges; ++v) {
+        for (std::uint32_t d = 0; d < degree && res.size() < num_edges;
+             ++d) {
+            const auto from = endpoints[rnd.below(
+                static_cast<std::uint32_t>(endpoints.size()))];
+            res.emplace_back(from, v);
+            endpoints.push_back(from);
+        }
+        endpoints.push_back(v);
+    }
+    return res;
+}
+
+/// \brief stages of equal width, every job depends on all jobs of the
+/// previous stage
+inline edges_t make_dense(size_t num_edges, std::uint32_t stages = 8)
+{
+    std::uint32_t width = 1;
+    while (size_t{ width + 1 } * (width + 1) * (stages - 1) <= num_edges) {
+        ++width;
+    }
+    edges_t res;
+    res.reserve(size_t{ width } * width * (stages - 1));
+    for (std::uint32_t s = 1; s < stages; ++s) {
+        for (std::uint32_t to = 0; to < width; ++to) {
+            for (std::uint32_t from = 0; from < width; ++from) {
+                res.emplace_back((s - 1) * width + from, s * width + to);
+            }
+        }
+    }
+    return res;
+}
+
+/// \brief the same graph with its job ids permuted and its edges in random
+/// order, like inputs generated from unordered sets
+inline edges_t shuffle(edges_t edges, std::uint64_t seed = 1)
+{
+    random rnd(seed);
+    std::uint32_t num_vertices = 0;
+    for (const auto & [ from, to ] : edges) {
+        num_vertices = std::max({ num_vertices, from + 1, to + 1 });
+    }
+    std::vector<std::uint32_t> ids(num_vertices);
+    for (std::uint32_t i = 0; i < num_vertices; ++i) {
+        ids[i] = i;
+    }
+    for (auto i = num_vertices; i > 1; --i) {
+        std::swap(ids[i - 1], ids[rnd.below(i)]);
+    }
+    for (auto i = static_cast<std::uint32_t>(edges.size()); i > 1; --i) {
+        std::swap(edges[i - 1], edges[rnd.below(i)]);
+    }
+    for (auto & [ from, to ] : edges) {
+        from = ids[from];
+        to = ids[to];
+    }
+    return edges;
+}
+
+/// \brief the edges in simplified dot format with labels "j<id>"
+inline std::string to_dot(const edges_t& edges)
+{
+    std::string res = "digraph G {\n";
+    res.reserve(edges.size() * 24);
+    for (const auto & [ from, to ] : edges) {
+        res += "    \"j";
+        res += std::to_string(from);
+        res += "\" -> \"j";
+        res += std::to_string(to);
+        res += "\";\n";
+    }
+    res += "}\n";
+    return res;
+}
+
+} // namespace bench
@@ -0,0 +1,182 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <job_graph.h>
+#include <parallel_schedule.h>
+#include <run_stats.h>
+#include <schedule_writer.h>
+#include <simplified_dot_parser.h>
+#include <thread_pool.h>
+#include <vertex_order.h>
+
+#include <dag_generators.h>
+
+namespace {
+
+std::atomic<size_t> allocations{ 0 };
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct workload {
+    std::string_view name;
+    std::function<bench::edges_t(size_t)> generate;
+};
+
+const workload workloads[] = {
+    { "chain", [](size_t n) { return bench::make_chain(n); } },
+    { "fan", [](size_t n) { return bench::make_fan(n); } },
+    { "layered", [](size_t n) { return bench::make_layered(n); } },
+    { "power_law", [](size_t n) { return bench::make_power_law(n); } },
+    { "dense", [](size_t n) { return bench::make_dense(n); } },
+    { "shuffled",
+        [](size_t n) { return bench::shuffle(bench::make_layered(n)); } },
+};
+
+struct options {
+    size_t min_edges = 1000;
+    size_t max_edges = 1000000;
+    std::string workload;
+    // threads of par_schedule, 0 is one per hardware thread
+    size_t threads = 0;
+    job_sheduler::schedule_format format = job_sheduler::schedule_format::table;
+};
+
+options parse_options(int argc, char* argv[])
+{
+    options res;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (i + 1 == argc) {
+            throw std::runtime_error("missing value for " + std::string(arg));
+        }
+        const std::string value(argv[++i]);
+        if (arg == "--min-edges") {
+            res.min_edges = std::stoull(value);
+        }
+        else if (arg == "--max-edges") {
+            res.max_edges = std::stoull(value);
+        }
+        else if (arg == "--workload") {
+            res.workload = value;
+        }
+        else if (arg == "--threads") {
+            res.threads = std::stoull(value);
+        }
+        else if (arg == "--format") {
+            res.format = job_sheduler::parse_schedule_format(value);
+        }
+        else {
+            throw std::runtime_error("invalid argument " + std::string(arg));
+        }
+    }
+    return res;
+}
+
+void print_header(std::ostream& os)
+{
+    os << std::left << std::setw(12) << "workload" << std::right
+       << std::setw(10) << "edges" << std::setw(16) << "phase"
+       << std::setw(12) << "ms" << std::setw(14) << "Medges/s"
+       << std::setw(12) << "allocs" << std::setw(14) << "peak RSS MB"
+       << '\n';
+}
+
+/// \brief runs f once, reports its wall time, throughput and allocations
+template <typename F>
+auto measure(std::string_view workload, size_t num_edges,
+    std::string_view phase, F&& f)
+{
+    const auto allocs_before = allocations.load();
+    const auto start = std::chrono::steady_clock::now();
+    auto res = f();
+    const auto end = std::chrono::steady_clock::now();
+    const auto allocs = allocations.load() - allocs_before;
+    const std::chrono::duration<double, std::milli> ms = end - start;
+    const auto throughput
+        = ms.count() > 0 ? num_edges / ms.count() / 1000.0 : 0.0;
+    std::cout << std::left << std::setw(12) << workload << std::right
+              << std::setw(10) << num_edges << std::setw(16) << phase
+              << std::setw(12) << std::fixed << std::setprecision(3)
+              << ms.count() << std::setw(14) << std::setprecision(2)
+              << throughput << std::setw(12) << allocs << std::setw(14)
+              << std::setprecision(1)
+              << job_sheduler::peak_rss_kb() / 1024.0 << '\n';
+    return res;
+}
+
+void run(const workload& w, size_t num_edges,
+    job_sheduler::schedule_format format, job_sheduler::thread_pool& pool)
+{
+    const auto text = bench::to_dot(w.generate(num_edges));
+    const auto edges = measure(w.name, num_edges, "parse",
+        [&] { return job_sheduler::utils::parse_simplified_dot(text); });
+    auto graph = measure(w.name, num_edges, "make_graph", [&] {
+        return job_sheduler::make_graph(edges.cbegin(), edges.cend());
+    });
+    // the cursor leaves the graph unscheduled for the sequential phase
+    measure(w.name, num_edges, "par_schedule", [&] {
+        return job_sheduler::parallel_schedule_cursor(graph, pool)
+            .get_full_schedule();
+    });
+    // the same schedule on a graph laid out level by level
+    auto reordered = measure(w.name, num_edges, "reorder",
+        [&] { return job_sheduler::reorder_by_level(graph); });
+    measure(w.name, num_edges, "reord_schedule",
+        [&] { return reordered.get_full_schedule(); });
+    const auto schedule = measure(w.name, num_edges, "schedule",
+        [&] { return graph.get_full_schedule(); });
+    measure(w.name, num_edges, "output", [&] {
+        std::ostringstream oss;
+        job_sheduler::write_schedule(oss, schedule, format);
+        return oss.tellp();
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) try {
+    const auto opts = parse_options(argc, argv);
+    job_sheduler::thread_pool pool(opts.threads);
+    print_header(std::cout);
+    for (const auto& w : workloads) {
+        if (!opts.workload.empty() && opts.workload != w.name) {
+            continue;
+        }
+        for (size_t n = opts.min_edges; n <= opts.max_edges; n *= 10) {
+            run(w, n, opts.format, pool);
+        }
+    }
+    return 0;
+}
+catch (const std::exception& e) {
+    std::cerr << "Exception occured:" << e.what() << '\n';
+    std::cerr << "Usage: " << argv[0]
+              << " [--min-edges <n>] [--max-edges <n>] [--workload <name>]"
+                 " [--threads <n>] [--format table|csv|json|binary]\n";
+    return -1;
+}
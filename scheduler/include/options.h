@@ -0,0 +1,266 @@
+#pragma once
+
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <schedule_service.h>
+#include <schedule_writer.h>
+
+namespace cli {
+
+/// \brief report of --stats
+enum class stats_output { none, text, json };
+
+/// \brief command line options of the scheduler
+struct options {
+    // more than one input file is a batch, see is_batch
+    std::vector<std::string> input_files;
+    size_t threads = 1;
+    // write the input graph in binary format instead of scheduling it
+    std::optional<std::string> emit_binary;
+    // the input is a binary graph, see write_binary_graph
+    bool binary_input = false;
+    // print a list schedule for this many workers instead of the levels
+    std::optional<size_t> workers;
+    // print the schedules of this many parts instead of the levels, see
+    // partition_graph
+    std::optional<size_t> partitions;
+    // job costs of the list schedule, see parse_job_costs
+    std::optional<std::string> costs_file;
+    // output format of the level schedule
+    job_sheduler::schedule_format format = job_sheduler::schedule_format::table;
+    // statistics of the run written to standard error
+    stats_output stats = stats_output::none;
+    // file listing the inputs of a batch, see parse_manifest
+    std::optional<std::string> manifest;
+    // directory of the schedules written in batch mode
+    std::optional<std::string> output_dir;
+    // graphs processed at the same time in batch mode, 0: one per thread
+    size_t jobs = 0;
+    // serve schedule requests on this unix domain socket, see
+    // schedule_service
+    std::optional<std::string> serve;
+    // bytes of the graphs cached by --serve, see schedule_service
+    size_t max_cache = job_sheduler::schedule_service::default_cache_size;
+    // largest request body accepted by --serve
+    size_t max_body = job_sheduler::schedule_service::default_max_body_size;
+    // directory of schedules cached by the content of their input
+    std::optional<std::string> cache_dir;
+    // remove duplicate and transitive edges of the input, see
+    // edge_reduction
+    bool reduce = false;
+
+    bool is_batch() const noexcept
+    {
+        return input_files.size() > 1 || manifest.has_value();
+    }
+};
+
+inline size_t parse_count(std::string_view name, const std::string& value)
+{
+    size_t pos = 0;
+    unsigned long long res = 0;
+    try {
+        res = std::stoull(value, &pos);
+    }
+    catch (const std::exception&) {
+        pos = 0;
+    }
+    if (pos == 0 || pos != value.size() || res == 0
+        || value.front() == '-') {
+        throw std::runtime_error(
+            "invalid value for " + std::string(name) + ": " + value);
+    }
+    return static_cast<size_t>(res);
+}
+
+inline options parse_options(int argc, char* argv[])
+{
+    options res;
+    bool has_serve_limits = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        const auto value = [&]() -> std::string {
+            if (i + 1 == argc) {
+                throw std::runtime_error(
+                    "missing value for " + std::string(arg));
+            }
+            return argv[++i];
+        };
+        if (arg == "--threads") {
+            res.threads = parse_count(arg, value());
+        }
+        else if (arg == "--emit-binary") {
+            res.emit_binary = value();
+        }
+        else if (arg == "--binary") {
+            res.binary_input = true;
+        }
+        else if (arg == "--workers") {
+            res.workers = parse_count(arg, value());
+        }
+        else if (arg == "--partitions") {
+            res.partitions = parse_count(arg, value());
+        }
+        else if (arg == "--costs") {
+            res.costs_file = value();
+        }
+        else if (arg == "--format") {
+            res.format = job_sheduler::parse_schedule_format(value());
+        }
+        else if (arg.substr(0, 9) == "--format=") {
+            res.format = job_sheduler::parse_schedule_format(arg.substr(9));
+        }
+        else if (arg == "--stats" || arg == "--stats=text") {
+            res.stats = stats_output::text;
+        }
+        else if (arg == "--stats=json") {
+            res.stats = stats_output::json;
+        }
+        else if (arg == "--manifest") {
+            res.manifest = value();
+        }
+        else if (arg == "--output-dir") {
+            res.output_dir = value();
+        }
+        else if (arg == "--jobs") {
+            res.jobs = parse_count(arg, value());
+        }
+        else if (arg == "--cache-dir") {
+            res.cache_dir = value();
+        }
+        else if (arg == "--reduce") {
+            res.reduce = true;
+        }
+        else if (arg == "--serve") {
+            res.serve = value();
+        }
+        else if (arg == "--max-cache") {
+            res.max_cache = parse_count(arg, value());
+            has_serve_limits = true;
+        }
+        else if (arg == "--max-body") {
+            res.max_body = parse_count(arg, value());
+            has_serve_limits = true;
+        }
+        else if (arg.substr(0, 2) != "--") {
+            res.input_files.emplace_back(arg);
+        }
+        else {
+            throw std::runtime_error("ivalid arguments...");
+        }
+    }
+    if (res.costs_file && !res.workers) {
+        throw std::runtime_error("--costs needs --workers");
+    }
+    if (res.workers && res.format != job_sheduler::schedule_format::table) {
+        throw std::runtime_error("--format can't be used with --workers");
+    }
+    if (res.partitions
+        && (res.workers || res.emit_binary
+            || res.format != job_sheduler::schedule_format::table)) {
+        throw std::runtime_error(
+            "--partitions can't be used with --workers, --emit-binary and "
+            "--format");
+    }
+    if (res.serve
+        && (!res.input_files.empty() || res.manifest || res.emit_binary
+            || res.workers || res.stats != stats_output::none)) {
+        throw std::runtime_error("--serve takes no inputs");
+    }
+    if (has_serve_limits && !res.serve) {
+        throw std::runtime_error("--max-cache and --max-body need --serve");
+    }
+    if (res.reduce && (res.binary_input || res.serve)) {
+        throw std::runtime_error("--reduce needs a dot input");
+    }
+    if (res.cache_dir
+        && (res.workers || res.partitions || res.emit_binary || res.serve
+            || res.is_batch())) {
+        throw std::runtime_error("--cache-dir caches only single schedules");
+    }
+    if (res.is_batch()) {
+        if (!res.output_dir) {
+            throw std::runtime_error("batch mode needs --output-dir");
+        }
+        if (res.emit_binary || res.stats != stats_output::none) {
+            throw std::runtime_error(
+                "--emit-binary and --stats can't be used in batch mode");
+        }
+    }
+    else if (res.output_dir || res.jobs != 0) {
+        throw std::runtime_error(
+            "--output-dir and --jobs need more inputs or --manifest");
+    }
+    return res;
+}
+
+inline void print_usage(std::ostream& os, const char* program)
+{
+    os << "Usage: " << program
+       << " [--threads <n>] [--binary] [--emit-binary <file>]"
+          " [--workers <n> [--costs <file>]] [--partitions <k>]"
+          " [--format table|csv|json|binary] [--stats[=text|json]]"
+          " [--cache-dir <dir>] [--reduce] [<filename>]\n"
+       << "       " << program
+       << " [options] --output-dir <dir> [--jobs <n>]"
+          " (--manifest <file> | <filename>...)\n"
+       << "       " << program
+       << " --serve <socket> [--max-cache <bytes>] [--max-body <bytes>]"
+       << '\n'
+       << R"#(
+ filename (optional)  - if given reads from file, 
+                        else from standard input, more files are scheduled
+                        in batch mode
+ --threads <n>        - parse and schedule the input on n threads (default
+                        1), in batch mode the size of the thread pool
+ --binary             - the input is a binary graph instead of a dot file
+ --emit-binary <file> - write the input graph to file in binary format
+                        instead of printing its schedule
+ --workers <n>        - print a critical path list schedule for n workers
+                        with the start and finish time of every job
+ --costs <file>       - estimated job costs for --workers, one job per line
+                        as "label" cost, jobs not listed cost 1
+ --partitions <k>     - split the jobs into k parts, e.g. for k nodes of a
+                        cluster, with few dependencies between the parts
+                        and print the steps of every part: the jobs of
+                        other parts to wait for, the jobs to run and the
+                        jobs other parts wait for
+ --format <format>    - output format of the schedule: table (default),
+                        csv (depth,vertex rows), json or binary (see
+                        binary_schedule_format), also --format=<format>
+ --stats[=text|json]  - write the time and allocations of every phase, the
+                        size of the graph and of its schedule and the peak
+                        memory to standard error, as text (default) or
+                        json
+ --cache-dir <dir>    - keep the schedules in dir keyed by a hash of the
+                        input, a repeated run on the same input streams the
+                        cached schedule without parsing, the cache can be
+                        shared by concurrent runs
+ --reduce             - remove repeated edges and edges implied by other
+                        paths before scheduling, the number of removed
+                        edges is written to standard error unless in batch
+                        mode
+ --manifest <file>    - batch mode, schedules the files listed in file, one
+                        path per line, lines starting with # are ignored
+ --output-dir <dir>   - batch mode, the schedule of every input is written
+                        to dir, named like the input with the extension of
+                        the format
+ --jobs <n>           - batch mode, schedule at most n graphs at the same
+                        time to bound the memory used (default --threads)
+ --serve <socket>     - answer schedule requests on a unix domain socket,
+                        parsed graphs are cached by the hash of their text,
+                        see schedule_service for the protocol
+ --max-cache <bytes>  - --serve keeps parsed graphs of at most this size,
+                        text included, the least recently used are dropped
+                        (default 1 GiB)
+ --max-body <bytes>   - --serve rejects larger graphs (default 16 MiB),
+                        every client being served may hold one in memory)#"
+       << '\n';
+}
+
+} // namespace cli
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <schedule_service.h>
+
+namespace cli {
+
+/// \brief owning file descriptor
+class unique_fd {
+public:
+    explicit unique_fd(int fd = -1) noexcept
+        : m_fd(fd)
+    {
+    }
+
+    unique_fd(unique_fd&& other) noexcept
+        : m_fd(std::exchange(other.m_fd, -1))
+    {
+    }
+
+    unique_fd& operator=(unique_fd&& other) noexcept
+    {
+        std::swap(m_fd, other.m_fd);
+        return *this;
+    }
+
+    ~unique_fd()
+    {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+
+    int get() const noexcept { return m_fd; }
+
+private:
+    int m_fd;
+};
+
+[[noreturn]] inline void throw_errno(const std::string& what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+/// \brief buffered reads and writes of a connected socket
+class connection {
+public:
+    explicit connection(unique_fd fd)
+        : m_fd(std::move(fd))
+    {
+    }
+
+    // request lines are short, longer lines are rejected by read_line
+    static constexpr size_t max_line_size = 4096;
+
+    /// \brief next line without the new line, false at the end of the
+    /// stream, throws std::length_error for lines longer than max_line_size
+    bool read_line(std::string& line)
+    {
+        line.clear();
+        for (;;) {
+            const auto nl = m_buffer.find('\n', m_pos);
+            const auto end = nl == std::string::npos ? m_buffer.size() : nl;
+            line.append(m_buffer, m_pos, end - m_pos);
+            if (line.size() > max_line_size) {
+                throw std::length_error("request line too long");
+            }
+            if (nl != std::string::npos) {
+                m_pos = nl + 1;
+                return true;
+            }
+            m_pos = m_buffer.size();
+            if (!fill()) {
+                return false;
+            }
+        }
+    }
+
+    /// \brief exactly size bytes, false if the stream ends before
+    ///
+    /// the size is declared by the client, data only grows with the bytes
+    /// actually received
+    bool read(std::string& data, size_t size)
+    {
+        data.clear();
+        while (data.size() < size) {
+            if (m_pos == m_buffer.size() && !fill()) {
+                return false;
+            }
+            const auto n
+                = std::min(size - data.size(), m_buffer.size() - m_pos);
+            data.append(m_buffer, m_pos, n);
+            m_pos += n;
+        }
+        return true;
+    }
+
+    void write(std::string_view data)
+    {
+        while (!data.empty()) {
+            const auto n
+                = ::send(m_fd.get(), data.data(), data.size(), MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw_errno("send");
+            }
+            data.remove_prefix(static_cast<size_t>(n));
+        }
+    }
+
+private:
+    bool fill()
+    {
+        constexpr size_t chunk_size = 64 * 1024;
+        m_buffer.resize(chunk_size);
+        m_pos = 0;
+        for (;;) {
+            const auto n = ::recv(m_fd.get(), m_buffer.data(), chunk_size, 0);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                throw_errno("recv");
+            }
+            m_buffer.resize(static_cast<size_t>(n));
+            return n != 0;
+        }
+    }
+
+    unique_fd m_fd;
+    std::string m_buffer;
+    size_t m_pos{};
+};
+
+/// \brief answers the requests of one client until it disconnects, a
+/// malformed or too long request line closes the connection as the size of
+/// its body is unknown
+inline void serve_client(
+    job_sheduler::schedule_service& service, connection client)
+{
+    std::string line;
+    std::string body;
+    for (;;) {
+        job_sheduler::service_request request;
+        try {
+            if (!client.read_line(line)) {
+                return;
+            }
+            request = job_sheduler::schedule_service::parse_request(
+                line, service.max_body_size());
+        }
+        catch (const std::logic_error& e) {
+            client.write("ERR " + std::string(e.what()) + '\n');
+            return;
+        }
+        if (!client.read(body, request.body_size)) {
+            return;
+        }
+        client.write(service.respond(request, body));
+    }
+}
+
+/// \brief threads running at most max_clients functions at a time, the
+/// threads are joined on destruction
+class client_threads {
+public:
+    explicit client_threads(size_t max_clients)
+        : m_max_clients(max_clients == 0 ? 1 : max_clients)
+    {
+    }
+
+    client_threads(const client_threads&) = delete;
+
+    client_threads& operator=(const client_threads&) = delete;
+
+    ~client_threads()
+    {
+        for (auto& e : m_clients) {
+            e.thread.join();
+        }
+    }
+
+    /// \brief runs f on its own thread, waits for a thread to finish if
+    /// max_clients are running, f must not throw
+    template <typename F>
+    void start(F f)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finished.wait(lock, [&] { return m_running < m_max_clients; });
+        for (auto it = m_clients.begin(); it != m_clients.end();) {
+            if (it->done) {
+                it->thread.join();
+                it = m_clients.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        auto& e = m_clients.emplace_back();
+        try {
+            e.thread = std::thread([this, &e, f = std::move(f)]() mutable {
+                f();
+                std::lock_guard<std::mutex> done_lock(m_mutex);
+                e.done = true;
+                --m_running;
+                m_finished.notify_one();
+            });
+        }
+        catch (...) {
+            m_clients.pop_back();
+            throw;
+        }
+        // the thread can't finish before as it needs the lock
+        ++m_running;
+    }
+
+private:
+    struct entry {
+        std::thread thread;
+        bool done{};
+    };
+
+    size_t m_max_clients;
+    std::mutex m_mutex;
+    std::condition_variable m_finished;
+    std::list<entry> m_clients;
+    size_t m_running{};
+};
+
+/// \brief true if no server listens on the socket at address, i.e. a
+/// connection to it is refused
+///
+/// the probe doesn't block, a server with a full backlog is still running
+inline bool is_stale_socket(const sockaddr_un& address)
+{
+    unique_fd probe(::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0));
+    if (probe.get() < 0) {
+        throw_errno("socket");
+    }
+    return ::connect(probe.get(), reinterpret_cast<const sockaddr*>(&address),
+               sizeof(address))
+        != 0
+        && errno == ECONNREFUSED;
+}
+
+/// \brief clients served at the same time by default, further clients wait
+/// in the backlog of the socket
+inline constexpr size_t default_max_clients = 64;
+
+/// \brief serves the schedule_service on a unix domain socket at path
+/// until the process is terminated, every client is served by its own
+/// thread, at most max_clients at a time, so up to max_clients bodies of
+/// the max_body_size of the service are read at the same time
+///
+/// the client threads are joined before serve returns or throws, so they
+/// never outlive the service
+inline void serve(job_sheduler::schedule_service& service,
+    const std::string& path, size_t max_clients = default_max_clients)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("socket path too long: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    unique_fd listener(::socket(AF_UNIX, SOCK_STREAM, 0));
+    if (listener.get() < 0) {
+        throw_errno("socket");
+    }
+    // a socket left behind by a previous server, any other file and the
+    // socket of a running server are kept
+    struct stat status{};
+    if (::lstat(path.c_str(), &status) == 0) {
+        if (!S_ISSOCK(status.st_mode) || !is_stale_socket(address)) {
+            throw std::runtime_error("address in use: " + path);
+        }
+        ::unlink(path.c_str());
+    }
+    if (::bind(listener.get(), reinterpret_cast<const sockaddr*>(&address),
+            sizeof(address))
+        != 0) {
+        throw_errno("bind " + path);
+    }
+    if (::listen(listener.get(), SOMAXCONN) != 0) {
+        throw_errno("listen " + path);
+    }
+    client_threads clients(max_clients);
+    for (;;) {
+        unique_fd client(::accept(listener.get(), nullptr, nullptr));
+        if (client.get() < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            throw_errno("accept");
+        }
+        clients.start([&service, fd = std::move(client)]() mutable {
+            try {
+                serve_client(service, connection(std::move(fd)));
+            }
+            catch (const std::exception&) {
+                // the client is gone, e.g. it closed the connection early
+            }
+        });
+    }
+}
+
+} // namespace cli
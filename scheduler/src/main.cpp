@@ -1,73 +1,378 @@
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <istream>
-#include <memory>
-#include <string>
-#include <utility>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
+#include <batch.h>
+#include <binary_graph.h>
+#include <input_buffer.h>
 #include <job_graph.h>
+#include <list_scheduler.h>
+#include <parallel_schedule.h>
+#include <partition.h>
+#include <run_stats.h>
+#include <schedule_cache.h>
+#include <schedule_range.h>
+#include <schedule_service.h>
+#include <schedule_writer.h>
 #include <simplified_dot_parser.h>
+#include <thread_pool.h>
+
+#include <options.h>
+#include <unix_server.h>
 
 using namespace std::literals;
 
-std::pair<std::istream*, std::unique_ptr<std::ifstream>> get_input_stream(
-    int argc, char* argv[])
+namespace {
+
+// allocations of the process, reported by --stats. They are only counted
+// with --stats, otherwise every allocation of the threads would contend on
+// the counter.
+std::atomic<bool> count_allocations{ false };
+std::atomic<size_t> allocations{ 0 };
+
+} // namespace
+
+void* operator new(size_t size)
 {
-    std::istream* is{};
-    std::unique_ptr<std::ifstream> ifs;
-    if (argc < 2) {
-        is = &std::cin;
+    if (count_allocations.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
     }
-    else if (argc == 2) {
-        ifs = std::make_unique<std::ifstream>(argv[1]);
-        is = ifs.get();
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
     }
-    else {
-        throw std::runtime_error("ivalid arguments...");
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+job_sheduler::utils::input_buffer get_input(const cli::options& opts)
+{
+    using job_sheduler::utils::input_buffer;
+    if (opts.input_files.empty()) {
+        return input_buffer::read_stream(std::cin);
     }
-    return std::make_pair(is, std::move(ifs));
+    return input_buffer::map_file(opts.input_files.front());
 }
 
-void print_usage(std::ostream& os, int argc, char* argv[])
+job_sheduler::edge_reduction edge_reduction(const cli::options& opts)
 {
-    os << "Usage: " << argv[0] << " [<filename>]" << '\n'
-       << R"#(
- filename (optional) - if given reads from file, 
-                       else from standard input)#"
-       << '\n';
+    return opts.reduce ? job_sheduler::edge_reduction::transitive
+                       : job_sheduler::edge_reduction::none;
 }
 
-const auto print_schedule = [](std::ostream& os, const auto& schedule) {
+auto parse_edges(const cli::options& opts, std::string_view text)
+{
+    if (opts.threads < 2) {
+        return job_sheduler::utils::parse_simplified_dot(text);
+    }
+    job_sheduler::thread_pool pool(opts.threads);
+    return job_sheduler::utils::parse_simplified_dot(text, pool);
+}
+
+template <typename GraphT>
+void print_list_schedule(
+    std::ostream& os, const GraphT& graph, const cli::options& opts)
+{
+    using job_sheduler::utils::input_buffer;
+    std::optional<input_buffer> costs_text;
+    std::unordered_map<std::string_view, double> costs;
+    if (opts.costs_file) {
+        costs_text = input_buffer::map_file(*opts.costs_file);
+        for (const auto & [ job, cost ] :
+            job_sheduler::utils::parse_job_costs(costs_text->view())) {
+            if (!graph.id_of(job)) {
+                throw std::runtime_error(
+                    "unknown job in costs file: " + std::string(job));
+            }
+            costs[job] = cost;
+        }
+    }
+    const auto schedule = job_sheduler::schedule_list(graph,
+        [&](std::string_view job) {
+            const auto it = costs.find(job);
+            return it == costs.end() ? 1.0 : it->second;
+        },
+        *opts.workers);
     constexpr auto field_size = 25;
-    os << std::left << std::setw(field_size) << "Depth" << ' '
-       << std::setw(field_size) << "Independent vertices" << '\n'
+    os << std::left << std::setw(field_size) << "Worker" << ' '
+       << std::setw(field_size) << "Jobs [start-finish]" << '\n'
        << std::setfill('=') << std::setw(2 * field_size) << '='
        << std::setfill(' ') << '\n';
-    for (auto it = schedule.cbegin(); it != schedule.cend(); ++it) {
-        os << std::setw(field_size) << std::distance(schedule.cbegin(), it) + 1;
-        std::copy(it->begin(), it->end(),
-            std::ostream_iterator<std::string>(os, ","));
+    for (size_t w = 0; w < schedule.workers.size(); ++w) {
+        os << std::setw(field_size) << w + 1;
+        for (const auto& job : schedule.workers[w]) {
+            os << graph.vertex_at(job.id) << '[' << job.start << '-'
+               << job.finish << "],";
+        }
         os << '\n';
     }
+    os << std::setw(field_size) << "Makespan" << schedule.makespan << '\n'
+       << std::setw(field_size) << "Critical path";
+    for (auto id : schedule.critical_path) {
+        os << graph.vertex_at(id) << ',';
+    }
+    os << '\n';
+}
+
+// the schedule is written while it is computed, it is never held in
+// memory as a whole. The graph is checked for cycles first (see
+// print_schedule), so no partial schedule is written.
+template <typename ScheduleT>
+void write_levels(std::ostream& os, const cli::options& opts,
+    ScheduleT& schedule, job_sheduler::run_stats& stats)
+{
+    if (opts.stats == cli::stats_output::none) {
+        job_sheduler::write_schedule(
+            os, job_sheduler::schedule_levels(schedule), opts.format);
+        return;
+    }
+    // scheduling and writing alternate, they are timed level by level
+    job_sheduler::schedule_writer writer(os, opts.format);
+    auto levels = job_sheduler::schedule_levels(schedule);
+    auto it = stats.measure("schedule", [&] { return levels.begin(); });
+    while (it != levels.end()) {
+        stats.add_level(it->size());
+        stats.measure("output", [&] { writer.write_level(*it); });
+        stats.measure("schedule", [&] { ++it; });
+    }
+    stats.measure("output", [&] { writer.finish(); });
+}
+
+// with --threads the levels of graphs that may have wide levels are
+// computed on a thread pool, in the same order as by the graph. In batch
+// mode the threads schedule different graphs instead. A cycle is reported
+// before any level is written.
+template <typename GraphT>
+void print_schedule(std::ostream& os, const cli::options& opts,
+    GraphT& graph, job_sheduler::run_stats& stats)
+{
+    stats.measure("check", [&] { job_sheduler::check_acyclic(graph); });
+    using cursor_type = job_sheduler::parallel_schedule_cursor<GraphT>;
+    if (opts.threads < 2 || opts.is_batch()
+        || graph.num_vertices() < 2 * cursor_type::default_grain) {
+        write_levels(os, opts, graph, stats);
+        return;
+    }
+    job_sheduler::thread_pool pool(opts.threads);
+    auto cursor = stats.measure("schedule",
+        [&] { return job_sheduler::parallel_schedule_cursor(graph, pool); });
+    write_levels(os, opts, cursor, stats);
+}
+
+template <typename GraphT>
+void process_graph(std::ostream& os, const cli::options& opts,
+    GraphT& graph, job_sheduler::run_stats& stats)
+{
+    stats.set_graph_size(graph.storage().size(), graph.num_edges());
+    if (opts.emit_binary) {
+        stats.measure("emit_binary", [&] {
+            std::ofstream ofs(*opts.emit_binary, std::ios::binary);
+            job_sheduler::write_binary_graph(ofs, graph);
+        });
+        return;
+    }
+    if (opts.workers) {
+        stats.measure("list_schedule",
+            [&] { print_list_schedule(os, graph, opts); });
+        return;
+    }
+    if (opts.partitions) {
+        const auto partition = stats.measure("partition", [&] {
+            return job_sheduler::partition_graph(graph, *opts.partitions);
+        });
+        stats.measure("output",
+            [&] { job_sheduler::write_partition(os, graph, partition); });
+        return;
+    }
+    print_schedule(os, opts, graph, stats);
+}
+
+void schedule_input(std::ostream& os, const cli::options& opts,
+    job_sheduler::utils::input_buffer input, job_sheduler::run_stats& stats)
+{
+    if (opts.binary_input) {
+        auto binary = stats.measure("load", [&] {
+            return job_sheduler::binary_graph::load(std::move(input));
+        });
+        process_graph(os, opts, binary.get(), stats);
+        return;
+    }
+    auto edges = stats.measure(
+        "parse", [&] { return parse_edges(opts, input.view()); });
+    auto graph = stats.measure("make_graph", [&] {
+        return job_sheduler::make_graph(edges.cbegin(), edges.cend(),
+            std::pmr::get_default_resource(), edge_reduction(opts));
+    });
+    if (opts.reduce && !opts.is_batch()) {
+        std::cerr << "Removed " << graph.num_reduced_edges() << " of "
+                  << edges.size() << " edges\n";
+    }
+    process_graph(os, opts, graph, stats);
+}
 
-};
+// a schedule that is not cached yet is written to the cache first, the
+// output is always streamed from the cache entry
+void schedule_cached(const cli::options& opts,
+    job_sheduler::utils::input_buffer input, job_sheduler::run_stats& stats)
+{
+    const job_sheduler::schedule_cache cache(*opts.cache_dir);
+    const auto entry = stats.measure("hash", [&] {
+        // the order within the levels of a reduced graph may differ
+        return cache.entry_path(input.view(),
+            std::string(opts.reduce ? ".reduced" : "")
+                .append(job_sheduler::schedule_file_extension(opts.format)));
+    });
+    auto cached = job_sheduler::schedule_cache::find(entry, input.view());
+    if (!cached) {
+        const auto text = input.view();
+        cached = job_sheduler::schedule_cache::store(
+            entry, text, [&](std::ostream& os) {
+                schedule_input(os, opts, std::move(input), stats);
+            });
+    }
+    stats.measure("cached_output", [&] {
+        const auto text = cached->schedule();
+        std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+        std::cout.flush();
+    });
+}
+
+void run(const cli::options& opts, job_sheduler::run_stats& stats)
+{
+    auto input = stats.measure("read", [&] { return get_input(opts); });
+    if (opts.cache_dir) {
+        schedule_cached(opts, std::move(input), stats);
+        return;
+    }
+    schedule_input(std::cout, opts, std::move(input), stats);
+}
+
+// schedules of a batch are named like the input with the extension of
+// the format
+std::filesystem::path output_path(
+    const cli::options& opts, const std::string& input)
+{
+    using job_sheduler::schedule_format;
+    const auto extension = job_sheduler::schedule_file_extension(
+        opts.workers ? schedule_format::table : opts.format);
+    auto name = std::filesystem::path(input).filename();
+    return std::filesystem::path(*opts.output_dir)
+        / name.replace_extension(extension);
+}
+
+// every graph of the batch is parsed and scheduled by a single thread of
+// the pool, failing inputs are reported and leave no output
+bool run_batch(const cli::options& opts)
+{
+    using job_sheduler::utils::input_buffer;
+    auto inputs = opts.input_files;
+    if (opts.manifest) {
+        const auto manifest = input_buffer::map_file(*opts.manifest);
+        for (auto path : job_sheduler::utils::parse_manifest(manifest.view())) {
+            inputs.emplace_back(path);
+        }
+    }
+    std::vector<std::filesystem::path> outputs;
+    std::set<std::filesystem::path> unique_outputs;
+    for (const auto& input : inputs) {
+        outputs.push_back(output_path(opts, input));
+        if (!unique_outputs.insert(outputs.back()).second) {
+            throw std::runtime_error(
+                "inputs with the same output: " + outputs.back().string());
+        }
+    }
+    std::filesystem::create_directories(*opts.output_dir);
+
+    job_sheduler::thread_pool pool(opts.threads);
+    const auto result = job_sheduler::run_batch(inputs.size(),
+        [&](size_t i) {
+            auto input = input_buffer::map_file(inputs[i]);
+            std::ofstream os(outputs[i], std::ios::binary);
+            if (!os) {
+                throw std::runtime_error(
+                    "can't open output " + outputs[i].string());
+            }
+            // the stats of a batch are not reported
+            job_sheduler::run_stats stats;
+            try {
+                if (opts.binary_input) {
+                    auto binary
+                        = job_sheduler::binary_graph::load(std::move(input));
+                    process_graph(os, opts, binary.get(), stats);
+                    return;
+                }
+                const auto edges = job_sheduler::utils::parse_simplified_dot(
+                    input.view());
+                auto graph = job_sheduler::make_graph(edges.cbegin(),
+                    edges.cend(), std::pmr::get_default_resource(),
+                    edge_reduction(opts));
+                process_graph(os, opts, graph, stats);
+            }
+            catch (...) {
+                os.close();
+                std::filesystem::remove(outputs[i]);
+                throw;
+            }
+        },
+        pool, opts.jobs);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        try {
+            if (result.errors[i]) {
+                std::rethrow_exception(result.errors[i]);
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << inputs[i] << ": " << e.what() << '\n';
+        }
+    }
+    return result.all_succeeded();
+}
 
 int main(int argc, char* argv[]) try {
-    auto[is, ifs] = get_input_stream(argc, argv);
-    auto edges = job_sheduler::utils::parse_simplified_dot(*is);
-    auto graph = job_sheduler::make_graph(edges.cbegin(), edges.cend());
-    auto schedule = graph.get_full_schedule();
-    print_schedule(std::cout, schedule);
+    const auto opts = cli::parse_options(argc, argv);
+    if (opts.serve) {
+        job_sheduler::schedule_service service(
+            opts.max_cache, opts.max_body);
+        cli::serve(service, *opts.serve);
+        return 0;
+    }
+    if (opts.is_batch()) {
+        return run_batch(opts) ? 0 : -1;
+    }
+    count_allocations.store(
+        opts.stats != cli::stats_output::none, std::memory_order_relaxed);
+    job_sheduler::run_stats stats(
+        [] { return allocations.load(std::memory_order_relaxed); });
+    run(opts, stats);
+    // the report goes to standard error to keep the schedule parseable
+    if (opts.stats == cli::stats_output::text) {
+        stats.write_text(std::cerr);
+    }
+    else if (opts.stats == cli::stats_output::json) {
+        stats.write_json(std::cerr);
+    }
     return 0;
 }
 catch (const std::exception& e) {
     std::cerr << "Exception occured:" << e.what() << '\n';
-    print_usage(std::cout, argc, argv);
+    cli::print_usage(std::cout, argv[0]);
     return -1;
 }
 catch (...) {
     std::cerr << "Unknown exception occured...\n";
-    print_usage(std::cout, argc, argv);
+    cli::print_usage(std::cout, argv[0]);
     return -1;
 }
\ No newline at end of file
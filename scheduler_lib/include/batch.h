@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include <simplified_dot_parser.h>
+#include <thread_pool.h>
+
+namespace job_sheduler {
+
+/// \brief outcome of every item of a batch indexed like the items
+struct batch_result {
+    // exception of the failed items, nullptr for the other ones
+    std::vector<std::exception_ptr> errors;
+
+    size_t num_failed() const noexcept
+    {
+        return static_cast<size_t>(std::count_if(errors.begin(), errors.end(),
+            [](const std::exception_ptr& e) { return e != nullptr; }));
+    }
+
+    bool all_succeeded() const noexcept { return num_failed() == 0; }
+};
+
+/// \brief calls process(i) for every i in [0, num_items) on the pool with
+/// at most max_in_flight items processed at the same time
+///
+/// every one of the max_in_flight tasks takes the next item when it is
+/// done with one, so the memory used for the items is bounded by the
+/// limit, not by the size of the batch. Items are started in order, a
+/// failing item does not stop the others. Must not be called from a
+/// worker of pool. max_in_flight == 0 means one item per pool thread.
+template <typename ProcessF>
+batch_result run_batch(size_t num_items, ProcessF&& process,
+    thread_pool& pool, size_t max_in_flight = 0)
+{
+    batch_result res;
+    res.errors.resize(num_items);
+    if (max_in_flight == 0) {
+        max_in_flight = pool.size();
+    }
+    std::atomic<size_t> next{ 0 };
+    const auto worker = [&] {
+        for (auto i = next++; i < num_items; i = next++) {
+            try {
+                process(i);
+            }
+            catch (...) {
+                res.errors[i] = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::future<void>> workers;
+    const auto num_workers = std::min(max_in_flight, num_items);
+    workers.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers.push_back(pool.submit(worker));
+    }
+    for (auto& w : workers) {
+        w.get();
+    }
+    return res;
+}
+
+namespace utils {
+
+/// \brief parses a manifest, one input path per line, surrounding white
+/// space is ignored as well as empty lines and lines starting with #, the
+/// paths point into text
+inline std::vector<std::string_view> parse_manifest(std::string_view text)
+{
+    std::vector<std::string_view> res;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const auto line = detail::trim(detail::next_line(text, pos));
+        if (!line.empty() && line.front() != '#') {
+            res.push_back(line);
+        }
+    }
+    return res;
+}
+
+} // namespace utils
+} // namespace job_sheduler
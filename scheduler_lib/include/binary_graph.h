@@ -0,0 +1,287 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <graph_storage.h>
+#include <input_buffer.h>
+#include <job_graph.h>
+
+namespace job_sheduler {
+
+/// \brief versioned binary graph format
+///
+/// \verbatim
+///  header       magic, version, byte order mark, #vertices, #edges,
+///               #label bytes
+///  u64[V+1]     label offsets
+///  char[]       labels, concatenated
+///  u64[V+1]     out edge offsets
+///  u32[E]       out edge targets
+///  u64[V+1]     in edge offsets
+///  u32[E]       in edge sources
+/// \endverbatim
+/// every section starts on an 8 byte boundary, numbers are stored in the
+/// byte order of the writer, loading a file of the other byte order fails
+namespace binary_format {
+
+constexpr char magic[8] = { 'J', 'S', 'G', 'R', 'A', 'P', 'H', '\0' };
+constexpr std::uint32_t version = 1;
+constexpr std::uint32_t byte_order_mark = 0x01020304;
+
+struct header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order_mark;
+    std::uint64_t num_vertices;
+    std::uint64_t num_edges;
+    std::uint64_t label_bytes;
+};
+
+constexpr size_t padding(size_t size) noexcept { return (8 - size % 8) % 8; }
+
+} // namespace binary_format
+
+/// \brief writes the structure of g (all vertices and edges regardless of
+/// the scheduling state) in binary format, vertices have to be string like,
+/// graphs with removed vertices are rejected
+template <typename VertexT, template <typename> class StorageT>
+void write_binary_graph(std::ostream& os, const graph<VertexT, StorageT>& g);
+
+/// \brief graph loaded from the binary format, vertex labels point into
+/// the memory mapped file owned by this object
+///
+/// loading copies the csr arrays in bulk and hashes the labels for the
+/// vertex index, there is no per edge parsing. Moving keeps the labels
+/// valid, the mapping (or the heap buffer of a non mapped input) does not
+/// relocate
+class binary_graph {
+public:
+    using graph_type = graph<std::string_view, csr_storage>;
+
+    static binary_graph load(const std::string& path);
+
+    static binary_graph load(utils::input_buffer buffer);
+
+    graph_type& get() noexcept { return *m_graph; }
+
+    const graph_type& get() const noexcept { return *m_graph; }
+
+private:
+    explicit binary_graph(utils::input_buffer buffer);
+
+    utils::input_buffer m_buffer;
+    std::optional<graph_type> m_graph;
+};
+
+namespace detail {
+
+inline void write_padding(std::ostream& os, size_t size)
+{
+    constexpr char zeros[8] = {};
+    os.write(zeros, binary_format::padding(size));
+}
+
+template <typename T>
+void write_array(std::ostream& os, const std::vector<T>& v)
+{
+    os.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+    write_padding(os, v.size() * sizeof(T));
+}
+
+template <typename StorageT, typename EdgesF>
+void write_csr(std::ostream& os, const StorageT& storage, EdgesF edges)
+{
+    std::vector<std::uint64_t> offsets{ 0 };
+    offsets.reserve(storage.size() + 1);
+    std::vector<vertex_id> targets;
+    targets.reserve(storage.num_edges());
+    for (vertex_id id = 0; id < storage.size(); ++id) {
+        const auto range = edges(storage, id);
+        targets.insert(targets.end(), range.begin(), range.end());
+        offsets.push_back(targets.size());
+    }
+    write_array(os, offsets);
+    write_array(os, targets);
+}
+
+// sequential reader of the sections of a binary graph
+class binary_reader {
+public:
+    explicit binary_reader(std::string_view data)
+        : m_data(data)
+    {
+    }
+
+    template <typename T>
+    std::pmr::vector<T> read_array(size_t count)
+    {
+        if (count > m_data.size() / sizeof(T)) {
+            throw std::runtime_error("truncated binary graph");
+        }
+        const auto bytes = take(count * sizeof(T));
+        std::pmr::vector<T> res(count);
+        // the data of an empty vector may be null
+        if (count != 0) {
+            std::memcpy(res.data(), bytes.data(), bytes.size());
+        }
+        return res;
+    }
+
+    std::string_view take(size_t size)
+    {
+        if (size > m_data.size() - m_pos) {
+            throw std::runtime_error("truncated binary graph");
+        }
+        const auto res = m_data.substr(m_pos, size);
+        m_pos += size;
+        m_pos += std::min(binary_format::padding(size), m_data.size() - m_pos);
+        return res;
+    }
+
+private:
+    std::string_view m_data;
+    size_t m_pos{};
+};
+
+inline std::pmr::vector<size_t> to_offsets(
+    const std::pmr::vector<std::uint64_t>& offsets, size_t total)
+{
+    for (size_t i = 1; i < offsets.size(); ++i) {
+        if (offsets[i] < offsets[i - 1]) {
+            throw std::runtime_error("invalid offsets in binary graph");
+        }
+    }
+    if (offsets.front() != 0 || offsets.back() != total) {
+        throw std::runtime_error("invalid offsets in binary graph");
+    }
+    return std::pmr::vector<size_t>(offsets.begin(), offsets.end());
+}
+
+inline void check_ids(const std::pmr::vector<vertex_id>& ids, size_t n)
+{
+    for (auto id : ids) {
+        if (id >= n) {
+            throw std::runtime_error("invalid vertex id in binary graph");
+        }
+    }
+}
+
+// the in edges have to be the transposed out edges, at least by degree
+inline void check_degrees(const std::pmr::vector<vertex_id>& out_targets,
+    const std::pmr::vector<size_t>& in_offsets)
+{
+    std::vector<size_t> in_degrees(in_offsets.size() - 1);
+    for (auto id : out_targets) {
+        ++in_degrees[id];
+    }
+    for (size_t i = 0; i < in_degrees.size(); ++i) {
+        if (in_degrees[i] != in_offsets[i + 1] - in_offsets[i]) {
+            throw std::runtime_error("inconsistent edges in binary graph");
+        }
+    }
+}
+
+} // namespace detail
+
+template <typename VertexT, template <typename> class StorageT>
+inline void write_binary_graph(
+    std::ostream& os, const graph<VertexT, StorageT>& g)
+{
+    const auto& storage = g.storage();
+    for (vertex_id id = 0; id < storage.size(); ++id) {
+        if (g.state(id) == vertex_state::removed) {
+            throw std::invalid_argument("graph with removed vertices");
+        }
+    }
+    std::vector<std::uint64_t> label_offsets{ 0 };
+    label_offsets.reserve(storage.size() + 1);
+    for (vertex_id id = 0; id < storage.size(); ++id) {
+        const std::string_view label(storage.elem(id));
+        label_offsets.push_back(label_offsets.back() + label.size());
+    }
+    binary_format::header h{};
+    std::memcpy(h.magic, binary_format::magic, sizeof(h.magic));
+    h.version = binary_format::version;
+    h.byte_order_mark = binary_format::byte_order_mark;
+    h.num_vertices = storage.size();
+    h.num_edges = storage.num_edges();
+    h.label_bytes = label_offsets.back();
+    os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    detail::write_array(os, label_offsets);
+    for (vertex_id id = 0; id < storage.size(); ++id) {
+        const std::string_view label(storage.elem(id));
+        os.write(label.data(), label.size());
+    }
+    detail::write_padding(os, h.label_bytes);
+    detail::write_csr(os, storage,
+        [](const auto& s, vertex_id id) { return s.out_edges(id); });
+    detail::write_csr(os, storage,
+        [](const auto& s, vertex_id id) { return s.in_edges(id); });
+    if (!os) {
+        throw std::runtime_error("error writing binary graph");
+    }
+}
+
+inline binary_graph binary_graph::load(const std::string& path)
+{
+    return binary_graph(utils::input_buffer::map_file(path));
+}
+
+inline binary_graph binary_graph::load(utils::input_buffer buffer)
+{
+    return binary_graph(std::move(buffer));
+}
+
+inline binary_graph::binary_graph(utils::input_buffer buffer)
+    : m_buffer(std::move(buffer))
+{
+    detail::binary_reader reader(m_buffer.view());
+    binary_format::header h{};
+    std::memcpy(&h, reader.take(sizeof(h)).data(), sizeof(h));
+    if (std::memcmp(h.magic, binary_format::magic, sizeof(h.magic)) != 0) {
+        throw std::runtime_error("not a binary graph");
+    }
+    if (h.byte_order_mark != binary_format::byte_order_mark) {
+        throw std::runtime_error("binary graph of different byte order");
+    }
+    if (h.version != binary_format::version) {
+        throw std::runtime_error("unsupported binary graph version "
+            + std::to_string(h.version));
+    }
+    detail::check_vertex_count(h.num_vertices);
+    const auto n = static_cast<size_t>(h.num_vertices);
+    const auto e = static_cast<size_t>(h.num_edges);
+    const auto label_offsets = detail::to_offsets(
+        reader.read_array<std::uint64_t>(n + 1), h.label_bytes);
+    const auto labels = reader.take(h.label_bytes);
+    std::pmr::vector<std::string_view> vertices;
+    vertices.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        vertices.push_back(labels.substr(
+            label_offsets[i], label_offsets[i + 1] - label_offsets[i]));
+    }
+    auto out_offsets
+        = detail::to_offsets(reader.read_array<std::uint64_t>(n + 1), e);
+    auto out_targets = reader.read_array<vertex_id>(e);
+    auto in_offsets
+        = detail::to_offsets(reader.read_array<std::uint64_t>(n + 1), e);
+    auto in_sources = reader.read_array<vertex_id>(e);
+    detail::check_ids(out_targets, n);
+    detail::check_ids(in_sources, n);
+    detail::check_degrees(out_targets, in_offsets);
+    m_graph.emplace(csr_storage<std::string_view>(std::move(vertices),
+        std::move(out_offsets), std::move(out_targets), std::move(in_offsets),
+        std::move(in_sources)));
+}
+
+} // namespace job_sheduler
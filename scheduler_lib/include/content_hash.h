@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace job_sheduler {
+
+namespace detail {
+
+// little endian load of up to 8 bytes, the same value on every platform
+inline std::uint64_t load_le(const char* p, size_t size) noexcept
+{
+    std::uint64_t res = 0;
+    for (size_t i = 0; i < size; ++i) {
+        res |= std::uint64_t{ static_cast<unsigned char>(p[i]) } << (8 * i);
+    }
+    return res;
+}
+
+// splitmix64 finalizer
+inline std::uint64_t mix(std::uint64_t h) noexcept
+{
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    return h;
+}
+
+} // namespace detail
+
+/// \brief 64 bit hash of the content of a graph file, graphs are
+/// identified by it
+///
+/// not cryptographic, but fast: the text is consumed 8 bytes per step.
+/// The hash is the same across processes and platforms, so it can be used
+/// for keys that are persisted.
+inline std::uint64_t content_hash(std::string_view text) noexcept
+{
+    constexpr std::uint64_t multiplier = 0x9e3779b97f4a7c15ull;
+    std::uint64_t hash = text.size() * multiplier;
+    const char* p = text.data();
+    auto rest = text.size();
+    for (; rest >= 8; p += 8, rest -= 8) {
+        hash = (hash ^ detail::mix(detail::load_le(p, 8))) * multiplier;
+    }
+    if (rest != 0) {
+        hash = (hash ^ detail::mix(detail::load_le(p, rest))) * multiplier;
+    }
+    return detail::mix(hash);
+}
+
+/// \brief content hash as 16 lower case hex digits
+inline std::string to_hex(std::uint64_t hash)
+{
+    constexpr char digits[] = "0123456789abcdef";
+    std::string res(16, '0');
+    for (auto it = res.rbegin(); it != res.rend(); ++it, hash >>= 4) {
+        *it = digits[hash & 0xf];
+    }
+    return res;
+}
+
+/// \brief parses to_hex, nullopt if text is not 16 hex digits
+inline std::optional<std::uint64_t> parse_hex(std::string_view text)
+{
+    if (text.size() != 16) {
+        return std::nullopt;
+    }
+    std::uint64_t res = 0;
+    for (auto c : text) {
+        int digit = -1;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        }
+        else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        }
+        if (digit < 0) {
+            return std::nullopt;
+        }
+        res = res << 4 | static_cast<std::uint64_t>(digit);
+    }
+    return res;
+}
+
+} // namespace job_sheduler
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <graph_storage.h>
+
+namespace job_sheduler {
+
+/// \brief preprocessing of the edges of a graph before it is built, see
+/// make_graph
+enum class edge_reduction {
+    none,
+    // repeated edges are kept once
+    duplicates,
+    // duplicates and edges implied by other paths are removed, the graph
+    // keeps its reachability and so its schedule
+    transitive
+};
+
+/// \brief removes repeated edges, the first one of every edge is kept in
+/// its place, returns the number of removed edges
+inline size_t remove_duplicate_edges(edge_list& edges)
+{
+    std::vector<size_t> order(edges.size());
+    std::iota(order.begin(), order.end(), size_t{ 0 });
+    std::stable_sort(order.begin(), order.end(),
+        [&](size_t lhs, size_t rhs) { return edges[lhs] < edges[rhs]; });
+    std::vector<bool> duplicate(edges.size());
+    for (size_t i = 1; i < order.size(); ++i) {
+        duplicate[order[i]] = edges[order[i]] == edges[order[i - 1]];
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < edges.size(); ++i) {
+        if (!duplicate[i]) {
+            edges[kept++] = edges[i];
+        }
+    }
+    const auto removed = edges.size() - kept;
+    edges.resize(kept);
+    return removed;
+}
+
+/// \brief removes duplicates and the edges u -> v where v is reachable
+/// from u by another path, the order of the remaining edges is kept.
+/// Returns the number of removed edges.
+///
+/// the reachability of the vertices is computed in reverse topological
+/// order as bitsets, in blocks of columns so that the bitsets take at most
+/// max_bitset_bytes, the time is O(V * E / 64). Graphs with cycles have no
+/// transitive reduction of this kind, only their duplicates are removed.
+inline size_t remove_transitive_edges(edge_list& edges, size_t num_vertices,
+    size_t max_bitset_bytes = size_t{ 64 } << 20)
+{
+    using word_t = std::uint64_t;
+    constexpr size_t word_bits = 64;
+    const auto duplicates = remove_duplicate_edges(edges);
+    const auto n = num_vertices;
+
+    // successors with the index of their edge
+    std::vector<size_t> offsets(n + 1);
+    std::vector<size_t> in_degree(n);
+    for (const auto& [ from, to ] : edges) {
+        ++offsets[from + 1];
+        ++in_degree[to];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<size_t> successors(edges.size());
+    {
+        auto next = offsets;
+        for (size_t e = 0; e < edges.size(); ++e) {
+            successors[next[edges[e].first]++] = e;
+        }
+    }
+
+    // topological order, position[v] is the index of v in it
+    std::vector<vertex_id> order;
+    order.reserve(n);
+    for (vertex_id v = 0; v < n; ++v) {
+        if (in_degree[v] == 0) {
+            order.push_back(v);
+        }
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (auto k = offsets[order[i]]; k < offsets[order[i] + 1]; ++k) {
+            const auto to = edges[successors[k]].second;
+            if (--in_degree[to] == 0) {
+                order.push_back(to);
+            }
+        }
+    }
+    if (order.size() != n) {
+        return duplicates;
+    }
+    std::vector<size_t> position(n);
+    for (size_t i = 0; i < n; ++i) {
+        position[order[i]] = i;
+    }
+    // successors closest in the order first, those further away may be
+    // reachable through them
+    for (vertex_id v = 0; v < n; ++v) {
+        std::sort(successors.begin() + offsets[v],
+            successors.begin() + offsets[v + 1], [&](size_t lhs, size_t rhs) {
+                return position[edges[lhs].second]
+                    < position[edges[rhs].second];
+            });
+    }
+
+    // columns [begin, end) of the order in a block, a vertex only reaches
+    // vertices after it, so only the first end rows are needed
+    const auto row_words = std::clamp<size_t>(
+        max_bitset_bytes / sizeof(word_t) / std::max<size_t>(n, 1), 1,
+        std::max<size_t>((n + word_bits - 1) / word_bits, 1));
+    const auto block_bits = row_words * word_bits;
+    std::vector<bool> redundant(edges.size());
+    std::vector<word_t> reach;
+    std::vector<word_t> covered(row_words);
+    for (size_t begin = 0; begin < n; begin += block_bits) {
+        const auto end = std::min(n, begin + block_bits);
+        reach.assign(end * row_words, 0);
+        for (auto p = end; p-- > 0;) {
+            const auto u = order[p];
+            std::fill(covered.begin(), covered.end(), 0);
+            for (auto k = offsets[u]; k < offsets[u + 1]; ++k) {
+                const auto q = position[edges[successors[k]].second];
+                if (q >= end) {
+                    break;
+                }
+                if (q >= begin) {
+                    const auto bit = q - begin;
+                    if (covered[bit / word_bits] >> (bit % word_bits) & 1) {
+                        redundant[successors[k]] = true;
+                    }
+                }
+                const auto* row = reach.data() + q * row_words;
+                for (size_t w = 0; w < row_words; ++w) {
+                    covered[w] |= row[w];
+                }
+            }
+            if (p >= begin) {
+                const auto bit = p - begin;
+                covered[bit / word_bits] |= word_t{ 1 } << (bit % word_bits);
+            }
+            std::copy(
+                covered.begin(), covered.end(), reach.begin() + p * row_words);
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t e = 0; e < edges.size(); ++e) {
+        if (!redundant[e]) {
+            edges[kept++] = edges[e];
+        }
+    }
+    const auto removed = edges.size() - kept;
+    edges.resize(kept);
+    return duplicates + removed;
+}
+
+/// \brief applies the reduction to the edges of a graph with num_vertices
+/// vertices, returns the number of removed edges
+inline size_t reduce_edges(
+    edge_list& edges, size_t num_vertices, edge_reduction reduction)
+{
+    switch (reduction) {
+    case edge_reduction::duplicates:
+        return remove_duplicate_edges(edges);
+    case edge_reduction::transitive:
+        return remove_transitive_edges(edges, num_vertices);
+    case edge_reduction::none:
+        break;
+    }
+    return 0;
+}
+
+} // namespace job_sheduler
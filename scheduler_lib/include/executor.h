@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <graph_storage.h>
+#include <vertex_index.h>
+#include <thread_pool.h>
+
+namespace job_sheduler {
+
+/// \brief outcome of a single job of an execution
+enum class job_status {
+    not_run, ///< never became ready, i.e. it is on or behind a cycle
+    succeeded, ///< the job returned normally
+    failed, ///< the job threw an exception
+    skipped, ///< a job it depends on failed or was skipped
+    removed, ///< the vertex was removed from the graph, it has no job
+};
+
+/// \brief status of every job of an execution indexed by vertex id
+struct execution_result {
+    std::vector<job_status> status;
+    // exception of the failed jobs, nullptr for the other ones
+    std::vector<std::exception_ptr> errors;
+
+    size_t count(job_status s) const noexcept
+    {
+        return static_cast<size_t>(std::count(status.begin(), status.end(), s));
+    }
+
+    bool all_succeeded() const noexcept
+    {
+        return count(job_status::succeeded) + count(job_status::removed)
+            == status.size();
+    }
+
+    /// \brief rethrows the exception of the failed job with the lowest id
+    void rethrow_failure() const
+    {
+        for (const auto& e : errors) {
+            if (e) {
+                std::rethrow_exception(e);
+            }
+        }
+    }
+};
+
+namespace detail {
+
+// a job is released when its last dependency finishes, there are no
+// barriers between the levels of the graph
+template <typename GraphT, typename JobF>
+class execution {
+public:
+    execution(const GraphT& graph, JobF& job, thread_pool& pool)
+        : m_graph(graph)
+        , m_job(job)
+        , m_pool(pool)
+        , m_pending(new std::atomic<size_t>[ storage().size() ])
+        , m_poisoned(new std::atomic<bool>[ storage().size() ])
+    {
+        const auto n = storage().size();
+        m_result.status.assign(n, job_status::not_run);
+        m_result.errors.resize(n);
+        for (vertex_id id = 0; id < n; ++id) {
+            m_pending[id].store(
+                storage().in_edges(id).size(), std::memory_order_relaxed);
+            m_poisoned[id].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    execution_result run()
+    {
+        std::vector<vertex_id> roots;
+        for (vertex_id id = 0; id < storage().size(); ++id) {
+            if (m_graph.state(id) == vertex_state::removed) {
+                m_result.status[id] = job_status::removed;
+            }
+            else if (storage().in_edges(id).empty()) {
+                roots.push_back(id);
+            }
+        }
+        if (roots.empty()) {
+            return std::move(m_result);
+        }
+        m_in_flight = roots.size();
+        for (auto id : roots) {
+            m_pool.post([this, id] { run_job(id); });
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done_cv.wait(lock, [this] { return m_done; });
+        return std::move(m_result);
+    }
+
+private:
+    const auto& storage() const noexcept { return m_graph.storage(); }
+
+    void run_job(vertex_id id)
+    {
+        try {
+            m_job(m_graph.vertex_at(id));
+            m_result.status[id] = job_status::succeeded;
+        }
+        catch (...) {
+            m_result.status[id] = job_status::failed;
+            m_result.errors[id] = std::current_exception();
+        }
+        release_successors(id);
+        finish_task();
+    }
+
+    // successors of skipped jobs are skipped right away, without tasks
+    void release_successors(vertex_id id)
+    {
+        std::vector<vertex_id> skipped;
+        for (;;) {
+            const bool failed = m_result.status[id] != job_status::succeeded;
+            for (auto s : storage().out_edges(id)) {
+                if (failed) {
+                    m_poisoned[s].store(true, std::memory_order_relaxed);
+                }
+                if (m_pending[s].fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                    continue;
+                }
+                if (m_poisoned[s].load(std::memory_order_relaxed)) {
+                    m_result.status[s] = job_status::skipped;
+                    skipped.push_back(s);
+                }
+                else {
+                    m_in_flight.fetch_add(1, std::memory_order_relaxed);
+                    m_pool.post([this, s] { run_job(s); });
+                }
+            }
+            if (skipped.empty()) {
+                return;
+            }
+            id = skipped.back();
+            skipped.pop_back();
+        }
+    }
+
+    void finish_task()
+    {
+        if (m_in_flight.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done = true;
+            m_done_cv.notify_all();
+        }
+    }
+
+    const GraphT& m_graph;
+    JobF& m_job;
+    thread_pool& m_pool;
+    std::unique_ptr<std::atomic<size_t>[]> m_pending;
+    std::unique_ptr<std::atomic<bool>[]> m_poisoned;
+    execution_result m_result;
+    std::atomic<size_t> m_in_flight{ 0 };
+    std::mutex m_mutex;
+    std::condition_variable m_done_cv;
+    bool m_done{};
+};
+
+} // namespace detail
+
+/// \brief runs job(vertex) for every vertex of graph on the pool, each job
+/// starts as soon as all the jobs it depends on have succeeded
+///
+/// the whole graph is executed regardless of its scheduling state (the
+/// graph is not modified), jobs depending on a failed job are skipped,
+/// independent jobs keep running. job may be invoked concurrently from
+/// several threads. Returns when no more jobs can run.
+template <typename GraphT, typename JobF>
+execution_result execute(const GraphT& graph, JobF&& job, thread_pool& pool)
+{
+    return detail::execution<GraphT, std::remove_reference_t<JobF>>(
+        graph, job, pool)
+        .run();
+}
+
+/// \brief execute on a pool of num_threads threads (0: hardware threads)
+template <typename GraphT, typename JobF>
+execution_result execute(
+    const GraphT& graph, JobF&& job, size_t num_threads = 0)
+{
+    thread_pool pool(num_threads);
+    return execute(graph, std::forward<JobF>(job), pool);
+}
+
+} // namespace job_sheduler
@@ -0,0 +1,433 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace job_sheduler {
+
+/// \brief dense index of a vertex inside of a graph storage
+using vertex_id = std::uint32_t;
+
+/// \brief list of edges given by the ids of their end points
+using edge_list = std::vector<std::pair<vertex_id, vertex_id>>;
+
+/// \brief contiguous read only range of vertex ids, e.g. neighbours of a
+/// vertex
+class id_range {
+public:
+    using iterator = const vertex_id*;
+
+    id_range() = default;
+    id_range(iterator first, iterator last) noexcept
+        : m_first(first)
+        , m_last(last)
+    {
+    }
+
+    iterator begin() const noexcept { return m_first; }
+    iterator end() const noexcept { return m_last; }
+    size_t size() const noexcept
+    {
+        return static_cast<size_t>(m_last - m_first);
+    }
+    bool empty() const noexcept { return m_first == m_last; }
+    vertex_id operator[](size_t i) const noexcept { return m_first[i]; }
+
+private:
+    iterator m_first{};
+    iterator m_last{};
+};
+
+namespace detail {
+
+inline void check_vertex_count(size_t n)
+{
+    if (n > std::numeric_limits<vertex_id>::max()) {
+        throw std::length_error("too many vertices for vertex_id");
+    }
+}
+
+// any contiguous container of vertex ids
+template <typename ContainerT>
+id_range to_range(const ContainerT& v) noexcept
+{
+    return id_range(v.data(), v.data() + v.size());
+}
+
+// copy or move of value using alloc if T is allocator aware, e.g. a
+// std::pmr::string vertex is put into the memory resource of its storage
+template <typename T, typename U, typename AllocatorT>
+T make_with_allocator(U&& value, const AllocatorT& alloc)
+{
+    if constexpr (std::uses_allocator_v<T, AllocatorT>) {
+        return T(std::forward<U>(value), alloc);
+    }
+    else {
+        return T(std::forward<U>(value));
+    }
+}
+
+} // namespace detail
+
+/// \brief default graph storage policy, every vertex owns its in and out
+/// edge lists, vertices and edges can be added and removed
+///
+/// all memory of the storage, including allocator aware vertices like
+/// std::pmr::string, comes from the memory resource given at construction,
+/// e.g. a std::pmr::monotonic_buffer_resource, copies use the same resource
+template <typename VertexT>
+class adjacency_list_storage {
+public:
+    using vertex_type = VertexT;
+    using allocator_type = std::pmr::polymorphic_allocator<vertex_id>;
+    using edges_t = std::pmr::vector<vertex_id>;
+
+    struct vertex {
+        using allocator_type = adjacency_list_storage::allocator_type;
+
+        vertex(vertex_type e, const allocator_type& alloc)
+            : elem(detail::make_with_allocator<vertex_type>(
+                  std::move(e), alloc))
+            , out(alloc)
+            , in(alloc)
+        {
+        }
+        vertex(const vertex& other, const allocator_type& alloc)
+            : elem(detail::make_with_allocator<vertex_type>(other.elem, alloc))
+            , out(other.out, alloc)
+            , in(other.in, alloc)
+        {
+        }
+        vertex(vertex&& other, const allocator_type& alloc)
+            : elem(detail::make_with_allocator<vertex_type>(
+                  std::move(other.elem), alloc))
+            , out(std::move(other.out), alloc)
+            , in(std::move(other.in), alloc)
+        {
+        }
+        vertex_type elem;
+        edges_t out;
+        edges_t in;
+    };
+
+    adjacency_list_storage(std::pmr::vector<vertex_type> vertices,
+        const edge_list& edges,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    adjacency_list_storage(const adjacency_list_storage& other);
+
+    adjacency_list_storage(adjacency_list_storage&&) = default;
+
+    adjacency_list_storage& operator=(const adjacency_list_storage&) = default;
+
+    adjacency_list_storage& operator=(adjacency_list_storage&&) = default;
+
+    std::pmr::memory_resource* resource() const noexcept
+    {
+        return m_vertices.get_allocator().resource();
+    }
+
+    size_t size() const noexcept { return m_vertices.size(); }
+    size_t num_edges() const noexcept { return m_num_edges; }
+
+    /// \brief bytes allocated for the vertices and their edge lists,
+    /// without the memory the payloads allocate themselves
+    size_t memory_usage() const noexcept;
+
+    vertex_type& elem(vertex_id id) noexcept { return m_vertices[id].elem; }
+    const vertex_type& elem(vertex_id id) const noexcept
+    {
+        return m_vertices[id].elem;
+    }
+
+    id_range out_edges(vertex_id id) const noexcept
+    {
+        return detail::to_range(m_vertices[id].out);
+    }
+    id_range in_edges(vertex_id id) const noexcept
+    {
+        return detail::to_range(m_vertices[id].in);
+    }
+
+    /// \brief appends a vertex without edges, returns its id
+    vertex_id add_vertex(vertex_type v);
+
+    void add_edge(vertex_id from, vertex_id to);
+
+    /// \brief removes one from -> to edge, returns false if there is none
+    bool remove_edge(vertex_id from, vertex_id to);
+
+    /// \brief removes every edge of the vertex, the vertex itself is kept
+    void remove_edges(vertex_id id);
+
+private:
+    static bool erase_one(edges_t& edges, vertex_id id);
+
+    std::pmr::vector<vertex> m_vertices;
+    size_t m_num_edges{};
+};
+
+/// \brief immutable compressed sparse row storage policy
+///
+/// out and in edges of all vertices are kept in two contiguous arrays of
+/// 32 bit vertex ids, the edges of vertex i are the elements in
+/// [offsets[i], offsets[i+1]), vertex payloads are stored separately.
+/// Memory comes from a memory resource like for adjacency_list_storage,
+/// with trivially destructible vertices (e.g. std::string_view) releasing
+/// the storage is a handful of deallocations
+template <typename VertexT>
+class csr_storage {
+public:
+    using vertex_type = VertexT;
+    using offsets_t = std::pmr::vector<size_t>;
+    using targets_t = std::pmr::vector<vertex_id>;
+
+    csr_storage(std::pmr::vector<vertex_type> vertices, const edge_list& edges,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /// \brief adopts already built csr arrays, offsets must have
+    /// vertices.size() + 1 elements, the arrays keep their memory resources
+    csr_storage(std::pmr::vector<vertex_type> vertices, offsets_t out_offsets,
+        targets_t out_targets, offsets_t in_offsets, targets_t in_sources);
+
+    csr_storage(const csr_storage& other);
+
+    csr_storage(csr_storage&&) = default;
+
+    csr_storage& operator=(const csr_storage&) = default;
+
+    csr_storage& operator=(csr_storage&&) = default;
+
+    std::pmr::memory_resource* resource() const noexcept
+    {
+        return m_elems.get_allocator().resource();
+    }
+
+    size_t size() const noexcept { return m_elems.size(); }
+    size_t num_edges() const noexcept { return m_out_targets.size(); }
+
+    /// \brief bytes allocated for the payloads and the csr arrays, without
+    /// the memory the payloads allocate themselves
+    size_t memory_usage() const noexcept
+    {
+        return m_elems.capacity() * sizeof(vertex_type)
+            + (m_out_offsets.capacity() + m_in_offsets.capacity())
+            * sizeof(size_t)
+            + (m_out_targets.capacity() + m_in_sources.capacity())
+            * sizeof(vertex_id);
+    }
+
+    vertex_type& elem(vertex_id id) noexcept { return m_elems[id]; }
+    const vertex_type& elem(vertex_id id) const noexcept { return m_elems[id]; }
+
+    id_range out_edges(vertex_id id) const noexcept
+    {
+        return slice(m_out_offsets, m_out_targets, id);
+    }
+    id_range in_edges(vertex_id id) const noexcept
+    {
+        return slice(m_in_offsets, m_in_sources, id);
+    }
+
+    const offsets_t& out_offsets() const noexcept { return m_out_offsets; }
+    const targets_t& out_targets() const noexcept { return m_out_targets; }
+    const offsets_t& in_offsets() const noexcept { return m_in_offsets; }
+    const targets_t& in_sources() const noexcept { return m_in_sources; }
+
+private:
+    static id_range slice(
+        const offsets_t& offsets, const targets_t& targets, vertex_id id)
+    {
+        return id_range(
+            targets.data() + offsets[id], targets.data() + offsets[id + 1]);
+    }
+
+    // counting sort of the edges by their first or second end point
+    template <typename KeyF, typename ValueF>
+    static void fill(size_t n, const edge_list& edges, KeyF key, ValueF value,
+        offsets_t& offsets, targets_t& targets);
+
+    std::pmr::vector<vertex_type> m_elems;
+    offsets_t m_out_offsets;
+    targets_t m_out_targets;
+    offsets_t m_in_offsets;
+    targets_t m_in_sources;
+};
+
+template <typename VertexT>
+inline adjacency_list_storage<VertexT>::adjacency_list_storage(
+    std::pmr::vector<vertex_type> vertices, const edge_list& edges,
+    std::pmr::memory_resource* resource)
+    : m_vertices(resource)
+    , m_num_edges(edges.size())
+{
+    detail::check_vertex_count(vertices.size());
+    m_vertices.reserve(vertices.size());
+    for (auto& v : vertices) {
+        m_vertices.emplace_back(std::move(v));
+    }
+    for (const auto & [ from, to ] : edges) {
+        m_vertices[from].out.push_back(to);
+        m_vertices[to].in.push_back(from);
+    }
+}
+
+template <typename VertexT>
+inline adjacency_list_storage<VertexT>::adjacency_list_storage(
+    const adjacency_list_storage& other)
+    : m_vertices(other.m_vertices, other.m_vertices.get_allocator())
+    , m_num_edges(other.m_num_edges)
+{
+}
+
+template <typename VertexT>
+inline size_t adjacency_list_storage<VertexT>::memory_usage() const noexcept
+{
+    auto res = m_vertices.capacity() * sizeof(vertex);
+    for (const auto& v : m_vertices) {
+        res += (v.out.capacity() + v.in.capacity()) * sizeof(vertex_id);
+    }
+    return res;
+}
+
+template <typename VertexT>
+inline vertex_id adjacency_list_storage<VertexT>::add_vertex(vertex_type v)
+{
+    detail::check_vertex_count(m_vertices.size() + 1);
+    m_vertices.emplace_back(std::move(v));
+    return static_cast<vertex_id>(m_vertices.size() - 1);
+}
+
+template <typename VertexT>
+inline void adjacency_list_storage<VertexT>::add_edge(
+    vertex_id from, vertex_id to)
+{
+    m_vertices[from].out.push_back(to);
+    m_vertices[to].in.push_back(from);
+    ++m_num_edges;
+}
+
+template <typename VertexT>
+inline bool adjacency_list_storage<VertexT>::remove_edge(
+    vertex_id from, vertex_id to)
+{
+    if (!erase_one(m_vertices[from].out, to)) {
+        return false;
+    }
+    erase_one(m_vertices[to].in, from);
+    --m_num_edges;
+    return true;
+}
+
+template <typename VertexT>
+inline void adjacency_list_storage<VertexT>::remove_edges(vertex_id id)
+{
+    const auto out = std::move(m_vertices[id].out);
+    const auto in = std::move(m_vertices[id].in);
+    m_vertices[id].out.clear();
+    m_vertices[id].in.clear();
+    for (auto s : out) {
+        if (s != id) {
+            erase_one(m_vertices[s].in, id);
+        }
+    }
+    for (auto p : in) {
+        if (p != id) {
+            erase_one(m_vertices[p].out, id);
+        }
+    }
+    // self loops are both in out and in
+    m_num_edges -= out.size() + in.size()
+        - static_cast<size_t>(std::count(in.begin(), in.end(), id));
+}
+
+template <typename VertexT>
+inline bool adjacency_list_storage<VertexT>::erase_one(
+    edges_t& edges, vertex_id id)
+{
+    const auto it = std::find(edges.begin(), edges.end(), id);
+    if (it == edges.end()) {
+        return false;
+    }
+    edges.erase(it);
+    return true;
+}
+
+template <typename VertexT>
+inline csr_storage<VertexT>::csr_storage(
+    std::pmr::vector<vertex_type> vertices, const edge_list& edges,
+    std::pmr::memory_resource* resource)
+    : m_elems(std::move(vertices), resource)
+    , m_out_offsets(resource)
+    , m_out_targets(resource)
+    , m_in_offsets(resource)
+    , m_in_sources(resource)
+{
+    detail::check_vertex_count(m_elems.size());
+    fill(m_elems.size(), edges, [](const auto& e) { return e.first; },
+        [](const auto& e) { return e.second; }, m_out_offsets, m_out_targets);
+    fill(m_elems.size(), edges, [](const auto& e) { return e.second; },
+        [](const auto& e) { return e.first; }, m_in_offsets, m_in_sources);
+}
+
+template <typename VertexT>
+inline csr_storage<VertexT>::csr_storage(
+    std::pmr::vector<vertex_type> vertices, offsets_t out_offsets,
+    targets_t out_targets, offsets_t in_offsets, targets_t in_sources)
+    : m_elems(std::move(vertices))
+    , m_out_offsets(std::move(out_offsets))
+    , m_out_targets(std::move(out_targets))
+    , m_in_offsets(std::move(in_offsets))
+    , m_in_sources(std::move(in_sources))
+{
+    detail::check_vertex_count(m_elems.size());
+    const auto n = m_elems.size();
+    if (m_out_offsets.size() != n + 1 || m_in_offsets.size() != n + 1
+        || m_out_offsets.back() != m_out_targets.size()
+        || m_in_offsets.back() != m_in_sources.size()
+        || m_out_targets.size() != m_in_sources.size()) {
+        throw std::invalid_argument("inconsistent csr arrays");
+    }
+}
+
+template <typename VertexT>
+inline csr_storage<VertexT>::csr_storage(const csr_storage& other)
+    : m_elems(other.m_elems, other.m_elems.get_allocator())
+    , m_out_offsets(other.m_out_offsets, other.m_out_offsets.get_allocator())
+    , m_out_targets(other.m_out_targets, other.m_out_targets.get_allocator())
+    , m_in_offsets(other.m_in_offsets, other.m_in_offsets.get_allocator())
+    , m_in_sources(other.m_in_sources, other.m_in_sources.get_allocator())
+{
+}
+
+template <typename VertexT>
+template <typename KeyF, typename ValueF>
+inline void csr_storage<VertexT>::fill(size_t n, const edge_list& edges,
+    KeyF key, ValueF value, offsets_t& offsets, targets_t& targets)
+{
+    offsets.assign(n + 1, 0);
+    for (const auto& e : edges) {
+        ++offsets[key(e) + 1];
+    }
+    for (size_t i = 0; i < n; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    targets.resize(edges.size());
+    // insert positions, shifted back to the offsets after filling
+    for (const auto& e : edges) {
+        targets[offsets[key(e)]++] = value(e);
+    }
+    for (size_t i = n; i > 0; --i) {
+        offsets[i] = offsets[i - 1];
+    }
+    offsets[0] = 0;
+}
+
+} // namespace job_sheduler
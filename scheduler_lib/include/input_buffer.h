@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cerrno>
+#include <istream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace job_sheduler {
+namespace utils {
+
+/// \brief the whole content of an input as one contiguous read only buffer
+///
+/// regular files are memory mapped, everything else (e.g. standard input,
+/// pipes) is read into memory in one go
+class input_buffer {
+public:
+    input_buffer() = default;
+
+    static input_buffer map_file(const std::string& path);
+
+    static input_buffer read_stream(std::istream& is);
+
+    input_buffer(input_buffer&& other) noexcept;
+
+    input_buffer& operator=(input_buffer&& other) noexcept;
+
+    input_buffer(const input_buffer&) = delete;
+
+    input_buffer& operator=(const input_buffer&) = delete;
+
+    ~input_buffer();
+
+    std::string_view view() const noexcept;
+
+    bool is_mapped() const noexcept { return m_mapped != nullptr; }
+
+private:
+    void unmap() noexcept;
+
+    void* m_mapped{};
+    size_t m_mapped_size{};
+    std::string m_content;
+};
+
+inline input_buffer input_buffer::map_file(const std::string& path)
+{
+    const auto throw_error = [&path](int error) {
+        throw std::system_error(
+            error, std::generic_category(), "can't read file " + path);
+    };
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw_error(errno);
+    }
+    struct stat st {
+    };
+    if (::fstat(fd, &st) != 0) {
+        const auto error = errno;
+        ::close(fd);
+        throw_error(error);
+    }
+    input_buffer res;
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        const auto size = static_cast<size_t>(st.st_size);
+        void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            const auto error = errno;
+            ::close(fd);
+            throw_error(error);
+        }
+        ::madvise(p, size, MADV_SEQUENTIAL);
+        res.m_mapped = p;
+        res.m_mapped_size = size;
+    }
+    else if (!S_ISREG(st.st_mode)) {
+        char chunk[1 << 16];
+        ssize_t n;
+        while ((n = ::read(fd, chunk, sizeof(chunk))) > 0) {
+            res.m_content.append(chunk, static_cast<size_t>(n));
+        }
+        if (n < 0) {
+            const auto error = errno;
+            ::close(fd);
+            throw_error(error);
+        }
+    }
+    ::close(fd);
+    return res;
+}
+
+inline input_buffer input_buffer::read_stream(std::istream& is)
+{
+    input_buffer res;
+    res.m_content.assign(std::istreambuf_iterator<char>(is), {});
+    return res;
+}
+
+inline input_buffer::input_buffer(input_buffer&& other) noexcept
+    : m_mapped(std::exchange(other.m_mapped, nullptr))
+    , m_mapped_size(std::exchange(other.m_mapped_size, 0))
+    , m_content(std::move(other.m_content))
+{
+}
+
+inline input_buffer& input_buffer::operator=(input_buffer&& other) noexcept
+{
+    if (this != &other) {
+        unmap();
+        m_mapped = std::exchange(other.m_mapped, nullptr);
+        m_mapped_size = std::exchange(other.m_mapped_size, 0);
+        m_content = std::move(other.m_content);
+    }
+    return *this;
+}
+
+inline input_buffer::~input_buffer() { unmap(); }
+
+inline std::string_view input_buffer::view() const noexcept
+{
+    if (m_mapped) {
+        return std::string_view(
+            static_cast<const char*>(m_mapped), m_mapped_size);
+    }
+    return m_content;
+}
+
+inline void input_buffer::unmap() noexcept
+{
+    if (m_mapped) {
+        ::munmap(m_mapped, m_mapped_size);
+        m_mapped = nullptr;
+        m_mapped_size = 0;
+    }
+}
+
+} // namespace utils
+} // namespace job_sheduler
@@ -1,16 +1,26 @@
 #pragma once
 
 #include <algorithm>
+#include <climits>
+#include <deque>
 #include <initializer_list>
 #include <iterator>
+#include <functional>
 #include <memory>
+#include <memory_resource>
 #include <numeric>
+#include <optional>
 #include <stdexcept>
 #include <tuple>
 #include <type_traits>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include <edge_reduction.h>
+#include <graph_storage.h>
+#include <vertex_index.h>
+
 namespace job_sheduler {
 
 namespace detail {
@@ -51,51 +61,62 @@ template <typename EdgeT, typename VertexF>
 using vertex_type_t = typename vertex_type<EdgeT, VertexF>::type;
 } // namespace detail
 
-template <typename VertexT>
+/// \brief job graph scheduled by topological depth
+///
+/// StorageT is the storage policy of the vertices and edges, see
+/// adjacency_list_storage and csr_storage. Vertices are interned to dense
+/// ids in order of their first appearance in the edge list, VertexT has to
+/// be hashable with std::hash. Lookup by key is O(1) expected, string like
+/// vertices can be looked up by std::string_view, see vertex_key
+///
+/// with adjacency_list_storage vertices and edges can be added and removed
+/// at any time of the scheduling, the levels of the affected vertices are
+/// updated incrementally. Mutations invalidate the iterators returned by
+/// find.
+///
+/// copies share the storage and the vertex index until one of them is
+/// modified, so a copy costs only the scheduling state of the vertices,
+/// see schedule_cursor for scheduling without modifying the graph
+///
+/// graphs built from edges put their storage into the given memory
+/// resource, use std::pmr::string vertices to have the labels there too.
+/// Their edges can be reduced before the storage is built, see
+/// edge_reduction, vertices are interned from all edges nevertheless
+template <typename VertexT,
+    template <typename> class StorageT = adjacency_list_storage>
 class graph {
 public:
-    struct vertex;
-
     using vertex_type = VertexT;
-    using vertex_ref_pointer = vertex*;
-    using vertex_ref_const_pointer = const vertex*;
-    using edges_t = std::vector<vertex_ref_pointer>;
-
-    struct vertex {
-        explicit vertex(vertex_type e)
-            : elem(std::move(e))
-        {
-        }
-        vertex_type elem;
-        edges_t out;
-        edges_t in;
-    };
-
-    using graph_t = std::vector<vertex>;
-    using graph_iterator = typename graph_t::iterator;
-    using graph_const_iterator = typename graph_t::const_iterator;
-    using view_t = std::vector<graph_iterator>;
+    using storage_type = StorageT<VertexT>;
+    using view_t = std::vector<vertex_id>;
     using view_iterator = typename view_t::iterator;
     using view_const_iterator = typename view_t::const_iterator;
 
     template <typename VertexF, typename EdgeT>
-    graph(VertexF vertex_func, const std::initializer_list<EdgeT>& edges);
+    graph(VertexF vertex_func, const std::initializer_list<EdgeT>& edges,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+        edge_reduction reduction = edge_reduction::none);
 
     template <typename VertexF, typename Iterator>
-    graph(VertexF vertex_func, Iterator begin, Iterator end);
+    graph(VertexF vertex_func, Iterator begin, Iterator end,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+        edge_reduction reduction = edge_reduction::none);
+
+    explicit graph(storage_type storage);
 
     graph(graph&&) = default;
 
     graph& operator=(graph&&) = default;
 
-    // TODO implement copy, disabled for now
-    graph(const graph&) = delete;
+    graph(const graph&) = default;
 
-    graph& operator=(const graph&) = delete;
+    graph& operator=(const graph&) = default;
 
     ~graph() = default;
 
-    view_const_iterator find(const vertex_type& key) const;
+    /// \brief finds a vertex that is not scheduled yet
+    template <typename KeyT>
+    view_const_iterator find(const KeyT& key) const;
 
     view_const_iterator end() const;
 
@@ -103,250 +124,508 @@ public:
 
     size_t num_edges() const noexcept;
 
+    /// \brief number of edges removed by the edge_reduction the graph was
+    /// built with, 0 for graphs built without one
+    size_t num_reduced_edges() const noexcept { return m_num_reduced_edges; }
+
     bool is_done() const noexcept;
 
+    const storage_type& storage() const noexcept;
+
+    /// \brief bytes allocated by the graph: its storage, the vertex index
+    /// and the scheduling state of the vertices, without the memory the
+    /// payloads allocate themselves. Copies sharing the storage count it
+    /// each.
+    size_t memory_usage() const noexcept;
+
+    /// \brief id of the vertex, valid for the whole lifetime of the graph
+    template <typename KeyT>
+    std::optional<vertex_id> id_of(const KeyT& key) const;
+
+    /// \brief vertex of the given id, precondition: id < storage().size()
+    const vertex_type& vertex_at(vertex_id id) const noexcept;
+
+    /// \brief state of the vertex, precondition: id < storage().size()
+    vertex_state state(vertex_id id) const noexcept;
+
+    /// \brief state of the vertex given by key, nullopt if there is none
+    template <typename KeyT>
+    std::optional<vertex_state> state_of(const KeyT& key) const;
+
+    /// \brief 0 based index of the level the vertex is (or was) scheduled
+    /// in, counting the levels from the start of the scheduling,
+    /// precondition: id < storage().size()
+    size_t level(vertex_id id) const noexcept;
+
+    /// \brief number of predecessors of the vertex that are not scheduled
+    /// yet, precondition: id < storage().size() and the vertex is pending or
+    /// ready
+    size_t pending(vertex_id id) const noexcept;
+
+    /// \brief ids of the vertices of the next level, in the order
+    /// next_level returns them
+    const view_t& ready() const noexcept;
+
+    /// \brief adds v without edges if it is not in the graph yet, returns
+    /// its id and whether it was added, a new vertex is part of the next
+    /// level
+    std::pair<vertex_id, bool> add_vertex(const vertex_type& v);
+
+    /// \brief adds the edge from -> to and the missing end points, to and
+    /// its descendants move to later levels as needed
+    ///
+    /// throws std::invalid_argument and leaves the graph unchanged if the
+    /// edge would close a cycle or if to is scheduled already
+    void add_edge(const vertex_type& from, const vertex_type& to);
+
+    /// \brief removes one from -> to edge, returns false if there is none,
+    /// to and its descendants move to earlier levels as possible
+    template <typename FromT, typename ToT>
+    bool remove_edge(const FromT& from, const ToT& to);
+
+    /// \brief removes the vertex and its edges, returns false if there is
+    /// none, its successors move to earlier levels as possible
+    ///
+    /// the id is not reused, the payload stays in storage() without edges
+    /// and the state of the id becomes vertex_state::removed
+    template <typename KeyT>
+    bool remove_vertex(const KeyT& key);
+
     std::vector<vertex_type> next_schedule();
 
+    /// \brief schedules the next level like next_schedule, but returns the
+    /// ids of its vertices, valid until the next call
+    const view_t& next_level();
+
     std::vector<std::vector<vertex_type>> get_full_schedule();
 
 private:
-    void restore_heap_property();
+    struct builder {
+        std::pmr::vector<vertex_type> vertices;
+        edge_list edges;
+        id_hash_table index;
+        size_t num_reduced_edges{};
+
+        vertex_id add_vertex_unique(const vertex_type& v);
+    };
 
-    void add_vertex_unique(const vertex_type& v);
-    template <typename VertexF, typename Iterator>
-    void add_vertices(VertexF func, Iterator begin, Iterator end);
     template <typename VertexF, typename Iterator>
-    void add_edges(VertexF func, Iterator begin, Iterator end);
+    static builder intern_edges(VertexF func, Iterator begin, Iterator end,
+        std::pmr::memory_resource* resource, edge_reduction reduction);
 
-    void add_view();
-    view_t get_all_done_vertices();
-    void remove_edges(view_iterator begin, view_iterator end);
-    static std::vector<vertex_type> to_vertices(view_t view);
+    explicit graph(builder b);
+
+    graph(storage_type storage, id_hash_table index);
 
-    vertex& find_vertex(const vertex_type& key);
+    template <typename KeyT>
+    static size_t hash(const KeyT& key);
+    template <typename KeyT>
+    vertex_id lookup(const KeyT& key) const;
+
+    void add_index();
+    void add_view();
+    void release_successors(view_iterator begin, view_iterator end);
+    std::vector<vertex_type> to_vertices(const view_t& view) const;
 
     void check_entry_point_exisits();
-    static auto graph_compare()
-    {
-        return [](const auto& lhs, const auto& rhs) {
-            return lhs->in.size() > rhs->in.size();
-        };
-    }
+
+    void add_levels();
+    size_t compute_level(vertex_id id) const;
+    void relevel(vertex_id id);
+    bool reaches(vertex_id from, vertex_id to) const;
+    void remove_ready(vertex_id id);
+
+    struct structure {
+        storage_type storage;
+        id_hash_table index;
+    };
+
+    // copy on write, the structure is shared with the copies of the graph
+    structure& mutable_structure();
 
     /*************************************/
-    graph_t m_graph;
+    std::shared_ptr<structure> m_structure;
+    // every vertex id of the graph, find points into it
     view_t m_view;
+    // vertices with no pending predecessors, i.e. the next schedule
+    view_t m_ready;
+    // the level scheduled last, its buffer is reused for the next one
+    view_t m_level;
+    // number of predecessors that are not scheduled yet per vertex
+    std::vector<size_t> m_pending;
+    // scheduled or removed
+    std::vector<bool> m_scheduled;
+    std::vector<bool> m_removed;
+    // level of every vertex, see level()
+    std::vector<size_t> m_levels;
+    size_t m_num_levels{};
+    size_t m_remaining{};
+    size_t m_num_reduced_edges{};
 
 }; // namespace job_sheduler
 
-template <typename VertexF, typename Iterator>
-auto make_graph(VertexF f, Iterator begin, Iterator end)
+template <template <typename> class StorageT = adjacency_list_storage,
+    typename VertexF, typename Iterator>
+auto make_graph(VertexF f, Iterator begin, Iterator end,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+    edge_reduction reduction = edge_reduction::none)
 {
     using traits = std::iterator_traits<Iterator>;
     using EdgeT = typename traits::value_type;
-    return graph<detail::vertex_type_t<EdgeT, VertexF>>(
-        std::move(f), begin, end);
+    return graph<detail::vertex_type_t<EdgeT, VertexF>, StorageT>(
+        std::move(f), begin, end, resource, reduction);
 }
 
-template <typename VertexF, typename EdgeT>
-auto make_graph(VertexF f, const std::initializer_list<EdgeT>& edges)
+template <template <typename> class StorageT = adjacency_list_storage,
+    typename VertexF, typename EdgeT>
+auto make_graph(VertexF f, const std::initializer_list<EdgeT>& edges,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+    edge_reduction reduction = edge_reduction::none)
 {
 
-    return graph<detail::vertex_type_t<EdgeT, VertexF>>(std::move(f), edges);
+    return graph<detail::vertex_type_t<EdgeT, VertexF>, StorageT>(
+        std::move(f), edges, resource, reduction);
 }
 
 // default is identity function
-template <typename EdgeT>
-auto make_graph(const std::initializer_list<EdgeT>& edges)
+template <template <typename> class StorageT = adjacency_list_storage,
+    typename EdgeT>
+auto make_graph(const std::initializer_list<EdgeT>& edges,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+    edge_reduction reduction = edge_reduction::none)
 {
-    return make_graph([](const auto& e) { return e; }, edges);
+    return make_graph<StorageT>(
+        [](const auto& e) { return e; }, edges, resource, reduction);
 }
 
-template <typename Iterator>
-auto make_graph(Iterator begin, Iterator end)
+template <template <typename> class StorageT = adjacency_list_storage,
+    typename Iterator>
+auto make_graph(Iterator begin, Iterator end,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+    edge_reduction reduction = edge_reduction::none)
 {
-    return make_graph([](const auto& e) { return e; }, begin, end);
+    return make_graph<StorageT>(
+        [](const auto& e) { return e; }, begin, end, resource, reduction);
 }
 
-template <typename VertexT>
+template <typename VertexT, template <typename> class StorageT>
 template <typename VertexF, typename Iterator>
-inline graph<VertexT>::graph(VertexF vertex_func, Iterator begin, Iterator end)
+inline graph<VertexT, StorageT>::graph(VertexF vertex_func, Iterator begin,
+    Iterator end, std::pmr::memory_resource* resource,
+    edge_reduction reduction)
+    : graph(intern_edges(
+          std::move(vertex_func), begin, end, resource, reduction))
 {
-    using traits = std::iterator_traits<Iterator>;
-    using EdgeT = typename traits::value_type;
-    using v_type = detail::vertex_type_t<EdgeT, VertexF>;
-    static_assert(std::is_convertible_v<v_type, vertex_type>);
-    add_vertices(vertex_func, begin, end);
-    add_edges(vertex_func, begin, end);
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline graph<VertexT, StorageT>::graph(builder b)
+    : graph(storage_type(std::move(b.vertices), b.edges,
+                b.vertices.get_allocator().resource()),
+          std::move(b.index))
+{
+    m_num_reduced_edges = b.num_reduced_edges;
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline graph<VertexT, StorageT>::graph(storage_type storage)
+    : graph(std::move(storage), id_hash_table{})
+{
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline graph<VertexT, StorageT>::graph(
+    storage_type storage, id_hash_table index)
+    : m_structure(std::make_shared<structure>(
+          structure{ std::move(storage), std::move(index) }))
+{
+    if (m_structure->index.size() != m_structure->storage.size()) {
+        add_index();
+    }
     add_view();
-    restore_heap_property();
     check_entry_point_exisits();
 }
 
-template <typename VertexT>
+template <typename VertexT, template <typename> class StorageT>
 template <typename VertexF, typename Iterator>
-inline void graph<VertexT>::add_vertices(
-    VertexF vertex_function, Iterator begin, Iterator end)
+inline auto graph<VertexT, StorageT>::intern_edges(
+    VertexF vertex_function, Iterator begin, Iterator end,
+    std::pmr::memory_resource* resource, edge_reduction reduction) -> builder
 {
-    m_graph.reserve(std::distance(begin, end));
+    using traits = std::iterator_traits<Iterator>;
+    using EdgeT = typename traits::value_type;
+    using v_type = detail::vertex_type_t<EdgeT, VertexF>;
+    static_assert(std::is_convertible_v<v_type, vertex_type>);
+    // the labels are put into the resource right away
+    builder b{ std::pmr::vector<vertex_type>(resource), {}, {}, 0 };
+    const auto num_edges = static_cast<size_t>(std::distance(begin, end));
+    b.edges.reserve(num_edges);
+    b.index.reserve(num_edges);
     for (; begin != end; ++begin) {
         const auto & [ from, to ] = vertex_function(*begin);
-        add_vertex_unique(from);
-        add_vertex_unique(to);
-    };
-    std::sort(m_graph.begin(), m_graph.end(),
-        [](const auto& lhs, const auto& rhs) { return lhs.elem < rhs.elem; });
+        const auto from_id = b.add_vertex_unique(from);
+        b.edges.emplace_back(from_id, b.add_vertex_unique(to));
+    }
+    b.num_reduced_edges = reduce_edges(b.edges, b.vertices.size(), reduction);
+    return b;
 }
 
-template <typename VertexT>
-template <typename VertexF, typename Iterator>
-inline void graph<VertexT>::add_edges(
-    VertexF vertex_function, Iterator begin, Iterator end)
+template <typename VertexT, template <typename> class StorageT>
+inline vertex_id graph<VertexT, StorageT>::builder::add_vertex_unique(
+    const vertex_type& v)
 {
-    for (; begin != end; ++begin) {
-        const auto & [ from, to ] = vertex_function(*begin);
-        auto& v_from = find_vertex(from);
-        auto& v_to = find_vertex(to);
-        v_from.out.push_back(std::addressof(v_to));
-        v_to.in.push_back(std::addressof(v_from));
+    auto[id, inserted] = index.insert(
+        hash(v), [&](vertex_id other) { return vertices[other] == v; });
+    if (inserted) {
+        vertices.push_back(v);
     }
+    return id;
+}
+
+template <typename VertexT, template <typename> class StorageT>
+template <typename KeyT>
+inline size_t graph<VertexT, StorageT>::hash(const KeyT& key)
+{
+    return vertex_key<vertex_type>::hash(key);
+}
+
+template <typename VertexT, template <typename> class StorageT>
+template <typename KeyT>
+inline vertex_id graph<VertexT, StorageT>::lookup(const KeyT& key) const
+{
+    return m_structure->index.find(hash(key), [&](vertex_id other) {
+        return vertex_key<vertex_type>::equal(storage().elem(other), key);
+    });
 }
 
-template <typename VertexT>
+template <typename VertexT, template <typename> class StorageT>
 template <typename VertexF, typename EdgeT>
-inline graph<VertexT>::graph(
-    VertexF vertex_func, const std::initializer_list<EdgeT>& edges)
-    : graph(std::move(vertex_func), edges.begin(), edges.end())
+inline graph<VertexT, StorageT>::graph(
+    VertexF vertex_func, const std::initializer_list<EdgeT>& edges,
+    std::pmr::memory_resource* resource, edge_reduction reduction)
+    : graph(std::move(vertex_func), edges.begin(), edges.end(), resource,
+          reduction)
 {
 }
 
-template <typename VertexT>
-inline auto graph<VertexT>::find(const vertex_type& key) const
+template <typename VertexT, template <typename> class StorageT>
+template <typename KeyT>
+inline auto graph<VertexT, StorageT>::find(const KeyT& key) const
     -> view_const_iterator
 {
-    return std::find_if(m_view.begin(), m_view.end(),
-        [&key](const auto& elem) { return elem->elem == key; });
+    const auto id = lookup(key);
+    if (id == invalid_vertex || m_scheduled[id]) {
+        return m_view.end();
+    }
+    return m_view.begin() + id;
 }
 
-template <typename VertexT>
-inline auto graph<VertexT>::end() const -> view_const_iterator
+template <typename VertexT, template <typename> class StorageT>
+inline auto graph<VertexT, StorageT>::end() const -> view_const_iterator
 {
     return m_view.end();
 }
 
-template <typename VertexT>
-inline size_t graph<VertexT>::num_vertices() const noexcept
+template <typename VertexT, template <typename> class StorageT>
+inline size_t graph<VertexT, StorageT>::num_vertices() const noexcept
 {
-    return m_view.size();
+    return m_remaining;
 }
 
-template <typename VertexT>
-inline size_t graph<VertexT>::num_edges() const noexcept
+template <typename VertexT, template <typename> class StorageT>
+inline size_t graph<VertexT, StorageT>::num_edges() const noexcept
 {
-    return std::accumulate(m_graph.begin(), m_graph.end(), size_t(0),
-        [](auto accu, const auto& v) { return accu + v.out.size(); });
+    return storage().num_edges();
 }
 
-template <typename VertexT>
-inline bool graph<VertexT>::is_done() const noexcept
+template <typename VertexT, template <typename> class StorageT>
+inline bool graph<VertexT, StorageT>::is_done() const noexcept
 {
-    return m_view.empty();
+    return m_remaining == 0;
 }
 
-template <typename VertexT>
-inline void graph<VertexT>::restore_heap_property()
+template <typename VertexT, template <typename> class StorageT>
+inline auto graph<VertexT, StorageT>::storage() const noexcept
+    -> const storage_type&
 {
-    std::make_heap(m_view.begin(), m_view.end(), graph_compare());
+    return m_structure->storage;
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline size_t graph<VertexT, StorageT>::memory_usage() const noexcept
+{
+    // the structure shares its allocation with the reference counts of the
+    // shared_ptr, a few words
+    constexpr size_t shared_count_size = 4 * sizeof(void*);
+    const auto bits = [](const std::vector<bool>& v) {
+        return (v.capacity() + CHAR_BIT - 1) / CHAR_BIT;
+    };
+    return sizeof(structure) + shared_count_size
+        + m_structure->storage.memory_usage()
+        + m_structure->index.memory_usage()
+        + (m_view.capacity() + m_ready.capacity() + m_level.capacity())
+        * sizeof(vertex_id)
+        + (m_pending.capacity() + m_levels.capacity()) * sizeof(size_t)
+        + bits(m_scheduled) + bits(m_removed);
 }
 
-template <typename VertexT>
-inline void graph<VertexT>::add_vertex_unique(const vertex_type& v)
+template <typename VertexT, template <typename> class StorageT>
+template <typename KeyT>
+inline auto graph<VertexT, StorageT>::id_of(const KeyT& key) const
+    -> std::optional<vertex_id>
 {
-    if (std::find_if(m_graph.begin(), m_graph.end(),
-            [&v](const auto& g) { return v == g.elem; })
-        == m_graph.end()) {
-        m_graph.emplace_back(v);
+    const auto id = lookup(key);
+    if (id == invalid_vertex) {
+        return std::nullopt;
     }
+    return id;
 }
 
-template <typename VertexT>
-inline void graph<VertexT>::add_view()
+template <typename VertexT, template <typename> class StorageT>
+inline auto graph<VertexT, StorageT>::vertex_at(vertex_id id) const noexcept
+    -> const vertex_type&
 {
-    m_view.reserve(m_graph.size());
-    for (auto it = m_graph.begin(); it != m_graph.end(); ++it) {
-        m_view.push_back(it);
+    return storage().elem(id);
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline vertex_state graph<VertexT, StorageT>::state(vertex_id id) const
+    noexcept
+{
+    if (m_removed[id]) {
+        return vertex_state::removed;
+    }
+    if (m_scheduled[id]) {
+        return vertex_state::scheduled;
     }
+    return m_pending[id] == 0 ? vertex_state::ready : vertex_state::pending;
 }
 
-template <typename VertexT>
-inline auto graph<VertexT>::find_vertex(const vertex_type& key) -> vertex&
+template <typename VertexT, template <typename> class StorageT>
+template <typename KeyT>
+inline auto graph<VertexT, StorageT>::state_of(const KeyT& key) const
+    -> std::optional<vertex_state>
 {
-    auto it = std::lower_bound(m_graph.begin(), m_graph.end(), key,
-        [](const auto& v, const auto& k) { return v.elem < k; });
-    if (it == m_graph.end() || it->elem < key) {
-        throw std::logic_error("error during vertex initialization");
+    const auto id = lookup(key);
+    if (id == invalid_vertex) {
+        return std::nullopt;
     }
-    return *it;
+    return state(id);
 }
 
-template <typename VertexT>
-inline void graph<VertexT>::check_entry_point_exisits()
+template <typename VertexT, template <typename> class StorageT>
+inline void graph<VertexT, StorageT>::add_index()
 {
-    if (!m_view.empty() && !m_view.front()->in.empty()) {
-        throw std::runtime_error("no entry point in graph");
+    auto& index = m_structure->index;
+    index = id_hash_table(storage().size());
+    for (vertex_id id = 0; id < storage().size(); ++id) {
+        const auto& v = storage().elem(id);
+        const auto inserted = index.insert(hash(v), [&](vertex_id other) {
+            return storage().elem(other) == v;
+        });
+        if (!inserted.second) {
+            throw std::invalid_argument("duplicate vertex in storage");
+        }
     }
 }
-template <typename VertexT>
-inline auto graph<VertexT>::get_all_done_vertices() -> view_t
+
+template <typename VertexT, template <typename> class StorageT>
+inline void graph<VertexT, StorageT>::add_view()
 {
-    view_t done;
-    while (!m_view.empty() && m_view.front()->in.empty()) {
-        std::pop_heap(m_view.begin(), m_view.end(), graph_compare());
-        done.push_back(m_view.back());
-        m_view.pop_back();
+    const auto n = storage().size();
+    m_view.resize(n);
+    std::iota(m_view.begin(), m_view.end(), vertex_id(0));
+    m_pending.resize(n);
+    m_scheduled.assign(n, false);
+    m_removed.assign(n, false);
+    for (vertex_id id = 0; id < n; ++id) {
+        m_pending[id] = storage().in_edges(id).size();
+        if (m_pending[id] == 0) {
+            m_ready.push_back(id);
+        }
     }
-    return done;
+    m_remaining = n;
+    add_levels();
 }
 
-template <typename VertexT>
-inline void graph<VertexT>::remove_edges(view_iterator begin, view_iterator end)
+template <typename VertexT, template <typename> class StorageT>
+inline void graph<VertexT, StorageT>::add_levels()
 {
-    std::for_each(begin, end, [this](const auto& d) {
-        auto& v = *d;
-        // remove out edges
-        std::for_each(v.out.begin(), v.out.end(), [&](auto p) {
-            p->in.erase(
-                std::remove(p->in.begin(), p->in.end(), std::addressof(v)),
-                p->in.end());
-        });
+    // the schedule computed ahead on a copy of the pending counts, the
+    // vertices behind a cycle keep level 0
+    auto pending = m_pending;
+    auto order = m_ready;
+    m_levels.assign(storage().size(), 0);
+    for (size_t i = 0; i < order.size(); ++i) {
+        const auto v = order[i];
+        for (auto s : storage().out_edges(v)) {
+            m_levels[s] = std::max(m_levels[s], m_levels[v] + 1);
+            if (--pending[s] == 0) {
+                order.push_back(s);
+            }
+        }
+    }
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline void graph<VertexT, StorageT>::check_entry_point_exisits()
+{
+    if (m_remaining != 0 && m_ready.empty()) {
+        throw std::runtime_error("no entry point in graph");
+    }
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline void graph<VertexT, StorageT>::release_successors(
+    view_iterator begin, view_iterator end)
+{
+    std::for_each(begin, end, [this](vertex_id v) {
+        m_scheduled[v] = true;
+        --m_remaining;
+        // every successor whose last pending predecessor is v becomes ready
+        for (auto s : storage().out_edges(v)) {
+            if (--m_pending[s] == 0) {
+                m_ready.push_back(s);
+            }
+        }
     });
 }
 
-template <typename VertexT>
-inline auto graph<VertexT>::to_vertices(view_t view) -> std::vector<vertex_type>
+template <typename VertexT, template <typename> class StorageT>
+inline auto graph<VertexT, StorageT>::to_vertices(const view_t& view) const
+    -> std::vector<vertex_type>
 {
     std::vector<vertex_type> res;
     res.reserve(view.size());
+    // payloads are copied, they stay valid for id_of and vertex_at
     std::transform(view.begin(), view.end(), std::back_inserter(res),
-        [](const auto& d) { return std::move(d->elem); });
+        [this](vertex_id id) { return storage().elem(id); });
     return res;
 }
 
-template <typename VertexT>
-inline auto graph<VertexT>::next_schedule() -> std::vector<vertex_type>
+template <typename VertexT, template <typename> class StorageT>
+inline auto graph<VertexT, StorageT>::next_schedule()
+    -> std::vector<vertex_type>
+{
+    return to_vertices(next_level());
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline auto graph<VertexT, StorageT>::next_level() -> const view_t&
 {
     if (is_done()) {
         throw std::runtime_error("all jobs are done");
     }
-    auto done = get_all_done_vertices();
-    remove_edges(done.begin(), done.end());
-    restore_heap_property();
+    m_level.clear();
+    m_level.swap(m_ready);
+    release_successors(m_level.begin(), m_level.end());
+    ++m_num_levels;
     check_entry_point_exisits();
-    return to_vertices(std::move(done));
+    return m_level;
 }
 
-template <typename VertexT>
-inline auto graph<VertexT>::get_full_schedule()
+template <typename VertexT, template <typename> class StorageT>
+inline auto graph<VertexT, StorageT>::get_full_schedule()
     -> std::vector<std::vector<vertex_type>>
 {
     std::vector<std::vector<vertex_type>> res;
@@ -356,4 +635,203 @@ inline auto graph<VertexT>::get_full_schedule()
     return res;
 }
 
-} // namespace job_sheduler
\ No newline at end of file
+template <typename VertexT, template <typename> class StorageT>
+inline size_t graph<VertexT, StorageT>::level(vertex_id id) const noexcept
+{
+    return m_levels[id];
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline size_t graph<VertexT, StorageT>::pending(vertex_id id) const noexcept
+{
+    return m_pending[id];
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline auto graph<VertexT, StorageT>::ready() const noexcept -> const view_t&
+{
+    return m_ready;
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline auto graph<VertexT, StorageT>::add_vertex(const vertex_type& v)
+    -> std::pair<vertex_id, bool>
+{
+    if (const auto id = lookup(v); id != invalid_vertex) {
+        return { id, false };
+    }
+    auto& s = mutable_structure();
+    const auto res = s.index.insert(hash(v), [](vertex_id) { return false; });
+    s.storage.add_vertex(v);
+    m_view.push_back(res.first);
+    m_pending.push_back(0);
+    m_scheduled.push_back(false);
+    m_removed.push_back(false);
+    m_levels.push_back(m_num_levels);
+    m_ready.push_back(res.first);
+    ++m_remaining;
+    return res;
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline void graph<VertexT, StorageT>::add_edge(
+    const vertex_type& from, const vertex_type& to)
+{
+    const auto from_id = lookup(from);
+    const auto to_id = lookup(to);
+    if (to_id != invalid_vertex && m_scheduled[to_id]) {
+        throw std::invalid_argument("edge into a scheduled vertex");
+    }
+    // a new end point has no edges, so it can't be on a cycle
+    if (from == to
+        || (from_id != invalid_vertex && to_id != invalid_vertex
+               && reaches(to_id, from_id))) {
+        throw std::invalid_argument("edge would create a cycle");
+    }
+    const auto f = add_vertex(from).first;
+    const auto t = add_vertex(to).first;
+    mutable_structure().storage.add_edge(f, t);
+    if (m_scheduled[f]) {
+        return;
+    }
+    if (m_pending[t]++ == 0) {
+        remove_ready(t);
+    }
+    relevel(t);
+}
+
+template <typename VertexT, template <typename> class StorageT>
+template <typename FromT, typename ToT>
+inline bool graph<VertexT, StorageT>::remove_edge(
+    const FromT& from, const ToT& to)
+{
+    const auto f = lookup(from);
+    const auto t = lookup(to);
+    if (f == invalid_vertex || t == invalid_vertex) {
+        return false;
+    }
+    const auto out = storage().out_edges(f);
+    if (std::find(out.begin(), out.end(), t) == out.end()) {
+        return false;
+    }
+    mutable_structure().storage.remove_edge(f, t);
+    // edges of scheduled vertices don't count in the schedule anymore
+    if (!m_scheduled[f]) {
+        if (--m_pending[t] == 0) {
+            m_ready.push_back(t);
+        }
+        relevel(t);
+    }
+    return true;
+}
+
+template <typename VertexT, template <typename> class StorageT>
+template <typename KeyT>
+inline bool graph<VertexT, StorageT>::remove_vertex(const KeyT& key)
+{
+    const auto id = lookup(key);
+    if (id == invalid_vertex) {
+        return false;
+    }
+    auto& s = mutable_structure();
+    s.index.erase(hash(key), [&](vertex_id other) { return other == id; });
+    const auto successors = s.storage.out_edges(id);
+    const std::vector<vertex_id> affected(
+        successors.begin(), successors.end());
+    if (!m_scheduled[id]) {
+        if (m_pending[id] == 0) {
+            remove_ready(id);
+        }
+        --m_remaining;
+        for (auto v : affected) {
+            if (v != id && --m_pending[v] == 0) {
+                m_ready.push_back(v);
+            }
+        }
+    }
+    m_scheduled[id] = true;
+    m_removed[id] = true;
+    s.storage.remove_edges(id);
+    for (auto v : affected) {
+        relevel(v);
+    }
+    return true;
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline auto graph<VertexT, StorageT>::mutable_structure() -> structure&
+{
+    if (m_structure.use_count() > 1) {
+        m_structure = std::make_shared<structure>(*m_structure);
+    }
+    return *m_structure;
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline size_t graph<VertexT, StorageT>::compute_level(vertex_id id) const
+{
+    size_t res = m_num_levels;
+    for (auto p : storage().in_edges(id)) {
+        if (!m_scheduled[p]) {
+            res = std::max(res, m_levels[p] + 1);
+        }
+    }
+    return res;
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline void graph<VertexT, StorageT>::relevel(vertex_id id)
+{
+    if (m_scheduled[id]) {
+        return;
+    }
+    // only the descendants whose level changes are visited
+    std::deque<vertex_id> queue{ id };
+    while (!queue.empty()) {
+        const auto v = queue.front();
+        queue.pop_front();
+        const auto level = compute_level(v);
+        if (level == m_levels[v]) {
+            continue;
+        }
+        m_levels[v] = level;
+        const auto successors = storage().out_edges(v);
+        queue.insert(queue.end(), successors.begin(), successors.end());
+    }
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline bool graph<VertexT, StorageT>::reaches(
+    vertex_id from, vertex_id to) const
+{
+    // levels grow along the edges of the vertices not scheduled yet, so
+    // only the ones below the level of to can be on a path to it
+    std::vector<vertex_id> stack{ from };
+    std::unordered_set<vertex_id> visited{ from };
+    while (!stack.empty()) {
+        const auto v = stack.back();
+        stack.pop_back();
+        if (v == to) {
+            return true;
+        }
+        for (auto s : storage().out_edges(v)) {
+            if (s == to
+                || (!m_scheduled[s] && m_levels[s] < m_levels[to]
+                       && visited.insert(s).second)) {
+                stack.push_back(s);
+            }
+        }
+    }
+    return false;
+}
+
+template <typename VertexT, template <typename> class StorageT>
+inline void graph<VertexT, StorageT>::remove_ready(vertex_id id)
+{
+    // the order of the vertices of a level is not specified
+    const auto it = std::find(m_ready.begin(), m_ready.end(), id);
+    *it = m_ready.back();
+    m_ready.pop_back();
+}
+
+} // namespace job_sheduler
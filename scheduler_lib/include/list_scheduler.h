@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <graph_storage.h>
+#include <simplified_dot_parser.h>
+#include <vertex_index.h>
+
+namespace job_sheduler {
+
+/// \brief a job placed on a worker by the list scheduler
+struct job_assignment {
+    vertex_id id{};
+    size_t worker{};
+    double start{};
+    double finish{};
+};
+
+/// \brief schedule of a graph for a fixed number of workers
+struct list_schedule {
+    // assignments of every worker ordered by start time
+    std::vector<std::vector<job_assignment>> workers;
+    // assignment of every job indexed by vertex id
+    std::vector<job_assignment> jobs;
+    // finish time of the last job
+    double makespan{};
+    // longest path of the graph by cost from an entry point to an exit,
+    // no schedule can be shorter than its length
+    std::vector<vertex_id> critical_path;
+    double critical_path_length{};
+};
+
+namespace detail {
+
+// topological order of all vertices of storage, throws on cycles
+template <typename StorageT>
+std::vector<vertex_id> topological_order(const StorageT& storage)
+{
+    const auto n = storage.size();
+    std::vector<size_t> pending(n);
+    std::vector<vertex_id> res;
+    res.reserve(n);
+    for (vertex_id id = 0; id < n; ++id) {
+        pending[id] = storage.in_edges(id).size();
+        if (pending[id] == 0) {
+            res.push_back(id);
+        }
+    }
+    for (size_t i = 0; i < res.size(); ++i) {
+        for (auto s : storage.out_edges(res[i])) {
+            if (--pending[s] == 0) {
+                res.push_back(s);
+            }
+        }
+    }
+    if (res.size() != n) {
+        throw std::runtime_error("cycle in job graph");
+    }
+    return res;
+}
+
+} // namespace detail
+
+/// \brief critical path list scheduling of graph on num_workers identical
+/// workers, cost(vertex) is the estimated duration of a job
+///
+/// the priority of a job is its upward rank, the length of the longest
+/// path by cost from the job to an exit of the graph (HEFT without
+/// communication costs). Ready jobs are taken by descending rank and
+/// appended to the worker where they finish first, idle gaps are not
+/// filled by later jobs. Like execute, the whole graph is scheduled
+/// regardless of its scheduling state, removed vertices are left out.
+/// Throws on cycles, on negative costs and if num_workers is 0.
+template <typename GraphT, typename CostF>
+list_schedule schedule_list(
+    const GraphT& graph, CostF&& cost, size_t num_workers)
+{
+    if (num_workers == 0) {
+        throw std::invalid_argument("list schedule needs workers");
+    }
+    const auto& storage = graph.storage();
+    const auto n = storage.size();
+    const auto order = detail::topological_order(storage);
+    std::vector<double> costs(n);
+    for (vertex_id id = 0; id < n; ++id) {
+        if (graph.state(id) == vertex_state::removed) {
+            continue;
+        }
+        costs[id] = static_cast<double>(cost(graph.vertex_at(id)));
+        if (!(costs[id] >= 0)) {
+            throw std::invalid_argument("invalid job cost");
+        }
+    }
+    std::vector<double> rank(n);
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        double longest = 0;
+        for (auto s : storage.out_edges(*it)) {
+            longest = std::max(longest, rank[s]);
+        }
+        rank[*it] = costs[*it] + longest;
+    }
+    // removed vertices have no edges, below every job they can't be on
+    // the critical path
+    for (vertex_id id = 0; id < n; ++id) {
+        if (graph.state(id) == vertex_state::removed) {
+            rank[id] = -1;
+        }
+    }
+
+    list_schedule res;
+    res.workers.resize(num_workers);
+    res.jobs.resize(n);
+    // ties are broken by the topological order, so zero cost jobs are
+    // still placed after the jobs they depend on
+    std::vector<size_t> position(n);
+    for (size_t i = 0; i < n; ++i) {
+        position[order[i]] = i;
+    }
+    const auto lower_priority = [&](vertex_id a, vertex_id b) {
+        return rank[a] != rank[b] ? rank[a] < rank[b]
+                                  : position[a] > position[b];
+    };
+    std::priority_queue<vertex_id, std::vector<vertex_id>,
+        decltype(lower_priority)>
+        ready(lower_priority);
+    std::vector<size_t> pending(n);
+    std::vector<double> ready_time(n);
+    for (vertex_id id = 0; id < n; ++id) {
+        res.jobs[id].id = id;
+        pending[id] = storage.in_edges(id).size();
+        if (pending[id] == 0 && graph.state(id) != vertex_state::removed) {
+            ready.push(id);
+        }
+    }
+    std::vector<double> available(num_workers);
+    while (!ready.empty()) {
+        const auto id = ready.top();
+        ready.pop();
+        // the job starts at the same time on every worker that is free when
+        // it becomes ready, the one free for the shortest time is taken to
+        // keep the other ones for the jobs that are ready earlier
+        size_t worker = 0;
+        for (size_t w = 1; w < num_workers; ++w) {
+            const auto start = std::max(available[w], ready_time[id]);
+            const auto best = std::max(available[worker], ready_time[id]);
+            if (start < best
+                || (start == best && available[w] > available[worker])) {
+                worker = w;
+            }
+        }
+        const auto start = std::max(available[worker], ready_time[id]);
+        const job_assignment job{ id, worker, start, start + costs[id] };
+        available[worker] = job.finish;
+        res.jobs[id] = job;
+        res.workers[worker].push_back(job);
+        res.makespan = std::max(res.makespan, job.finish);
+        for (auto s : storage.out_edges(id)) {
+            ready_time[s] = std::max(ready_time[s], job.finish);
+            if (--pending[s] == 0) {
+                ready.push(s);
+            }
+        }
+    }
+
+    // the job of the highest priority is an entry point, a successor of the
+    // highest priority continues the longest path
+    if (n == 0) {
+        return res;
+    }
+    auto id = *std::max_element(order.begin(), order.end(), lower_priority);
+    if (rank[id] < 0) {
+        return res;
+    }
+    res.critical_path_length = rank[id];
+    for (;;) {
+        res.critical_path.push_back(id);
+        const auto succ = storage.out_edges(id);
+        if (succ.empty()) {
+            break;
+        }
+        id = *std::max_element(succ.begin(), succ.end(), lower_priority);
+    }
+    return res;
+}
+
+namespace utils {
+
+/// \brief job cost of a costs file, the label points into the parsed text
+using cost_view = std::pair<std::string_view, double>;
+
+/// \brief parses a costs file, one job per line in the format
+/// \verbatim
+///  "a" 2.5
+/// \endverbatim
+/// the label is quoted like in the dot file, empty lines are ignored
+inline std::vector<cost_view> parse_job_costs(std::string_view text)
+{
+    const auto throw_cost_error = [](size_t i, std::string_view line) {
+        throw std::runtime_error("costs file error on line "
+            + std::to_string(i) + ':' + std::string(line));
+    };
+    std::vector<cost_view> res;
+    size_t pos = 0;
+    size_t lines = 0;
+    while (pos < text.size()) {
+        const auto line = detail::next_line(text, pos);
+        ++lines;
+        if (detail::is_empty_line(line)) {
+            continue;
+        }
+        auto rest = detail::trim(line);
+        cost_view cost;
+        if (!detail::consume_label(rest, cost.first)) {
+            throw_cost_error(lines, line);
+        }
+        const std::string number(detail::trim(rest));
+        char* end = nullptr;
+        cost.second = std::strtod(number.c_str(), &end);
+        if (number.empty() || end != number.c_str() + number.size()
+            || !(cost.second >= 0)) {
+            throw_cost_error(lines, line);
+        }
+        res.push_back(cost);
+    }
+    return res;
+}
+
+} // namespace utils
+} // namespace job_sheduler
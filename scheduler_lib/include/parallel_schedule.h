@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <graph_storage.h>
+#include <thread_pool.h>
+#include <vertex_index.h>
+
+namespace job_sheduler {
+
+namespace detail {
+
+// f(task, begin, end) for consecutive chunks of [0, n) of at least grain
+// items, the calling thread takes the first chunk
+template <typename F>
+void parallel_chunks(thread_pool& pool, size_t n, size_t grain, F&& f)
+{
+    const auto num_tasks
+        = std::max<size_t>(1, std::min(pool.size() + 1, n / grain));
+    const auto chunk = (n + num_tasks - 1) / num_tasks;
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(num_tasks - 1);
+    for (size_t t = 1; t < num_tasks; ++t) {
+        const auto begin = std::min(n, t * chunk);
+        const auto end = std::min(n, begin + chunk);
+        tasks.push_back(pool.submit([&f, t, begin, end] { f(t, begin, end); }));
+    }
+    f(size_t{ 0 }, size_t{ 0 }, std::min(n, chunk));
+    for (auto& t : tasks) {
+        t.get();
+    }
+}
+
+} // namespace detail
+
+/// \brief schedules a graph without modifying it like schedule_cursor,
+/// wide levels are computed on a thread pool
+///
+/// a level of at least 2 * grain vertices is split across the threads in
+/// two passes: the first counts down the pending predecessors of the
+/// successors and records the last edge of the level to every successor,
+/// the second collects the successors that became ready at their last edge
+/// in a buffer per thread. The buffers are joined in the order of the
+/// level, so the levels are the ones of graph::next_level in the same
+/// order whatever the timing of the threads. Narrower levels are scheduled
+/// by the calling thread alone like by schedule_cursor. Must not be used
+/// from a worker of the pool.
+template <typename GraphT>
+class parallel_schedule_cursor {
+public:
+    using vertex_type = typename GraphT::vertex_type;
+    using view_t = std::vector<vertex_id>;
+
+    // levels narrower than 2 * grain are not split
+    static constexpr size_t default_grain = 4096;
+
+    parallel_schedule_cursor(const GraphT& graph, thread_pool& pool,
+        size_t grain = default_grain);
+
+    /// \brief number of vertices not scheduled by the cursor yet
+    size_t num_vertices() const noexcept { return m_remaining; }
+
+    bool is_done() const noexcept { return m_remaining == 0; }
+
+    const vertex_type& vertex_at(vertex_id id) const noexcept
+    {
+        return m_graph->vertex_at(id);
+    }
+
+    /// \brief see graph::next_level
+    const view_t& next_level();
+
+    std::vector<vertex_type> next_schedule();
+
+    std::vector<std::vector<vertex_type>> get_full_schedule();
+
+private:
+    void check_entry_point_exists() const
+    {
+        if (m_remaining != 0 && m_ready.empty()) {
+            throw std::runtime_error("no entry point in graph");
+        }
+    }
+
+    bool active(vertex_id id) const noexcept
+    {
+        const auto state = m_graph->state(id);
+        return state == vertex_state::pending || state == vertex_state::ready;
+    }
+
+    // position of the edge to the index-th successor of the vertex at
+    // position in the order the cursor schedules the vertices, the last
+    // edge to a vertex releases it
+    static std::uint64_t edge_key(size_t position, size_t index) noexcept
+    {
+        return (std::uint64_t{ position } << 32) | index;
+    }
+
+    void release_sequential();
+
+    void release_parallel();
+
+    // appends the buffers of the tasks to m_ready
+    void gather();
+
+    const GraphT* m_graph;
+    thread_pool* m_pool;
+    size_t m_grain;
+    view_t m_ready;
+    view_t m_level;
+    std::unique_ptr<std::atomic<size_t>[]> m_pending;
+    // last edge_key to every vertex, allocated for the first wide level
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_last_edge;
+    // buffer of every task, reused for all levels
+    std::vector<view_t> m_buffers;
+    size_t m_remaining{};
+    // vertices scheduled by the cursor before m_level
+    size_t m_scheduled{};
+};
+
+template <typename GraphT>
+inline parallel_schedule_cursor<GraphT>::parallel_schedule_cursor(
+    const GraphT& graph, thread_pool& pool, size_t grain)
+    : m_graph(&graph)
+    , m_pool(&pool)
+    , m_grain(std::max<size_t>(1, grain))
+    , m_ready(graph.ready())
+    , m_pending(new std::atomic<size_t>[graph.storage().size()])
+    , m_buffers(pool.size() + 1)
+    , m_remaining(graph.num_vertices())
+{
+    // the graph holds the pending counts of its scheduling state already
+    detail::parallel_chunks(*m_pool, graph.storage().size(), m_grain,
+        [&](size_t, size_t begin, size_t end) {
+            for (auto id = static_cast<vertex_id>(begin); id < end; ++id) {
+                m_pending[id].store(active(id) ? graph.pending(id) : 0,
+                    std::memory_order_relaxed);
+            }
+        });
+    check_entry_point_exists();
+}
+
+template <typename GraphT>
+inline void parallel_schedule_cursor<GraphT>::gather()
+{
+    size_t size = m_ready.size();
+    for (const auto& b : m_buffers) {
+        size += b.size();
+    }
+    m_ready.reserve(size);
+    for (auto& b : m_buffers) {
+        m_ready.insert(m_ready.end(), b.begin(), b.end());
+        b.clear();
+    }
+}
+
+template <typename GraphT>
+inline void parallel_schedule_cursor<GraphT>::release_sequential()
+{
+    // no other thread touches the counts, no read-modify-write needed
+    for (auto v : m_level) {
+        for (auto s : m_graph->storage().out_edges(v)) {
+            const auto pending
+                = m_pending[s].load(std::memory_order_relaxed) - 1;
+            m_pending[s].store(pending, std::memory_order_relaxed);
+            if (pending == 0) {
+                m_ready.push_back(s);
+            }
+        }
+    }
+}
+
+template <typename GraphT>
+inline void parallel_schedule_cursor<GraphT>::release_parallel()
+{
+    const auto& storage = m_graph->storage();
+    if (!m_last_edge) {
+        m_last_edge.reset(new std::atomic<std::uint64_t>[storage.size()]());
+    }
+    // the passes are separated by waiting for the tasks, the counts and
+    // keys written by the first are visible to the second
+    detail::parallel_chunks(*m_pool, m_level.size(), m_grain,
+        [&](size_t, size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                const auto successors = storage.out_edges(m_level[i]);
+                for (size_t j = 0; j < successors.size(); ++j) {
+                    const auto s = successors[j];
+                    m_pending[s].fetch_sub(1, std::memory_order_relaxed);
+                    const auto key = edge_key(m_scheduled + i, j);
+                    auto last = m_last_edge[s].load(std::memory_order_relaxed);
+                    while (last < key
+                        && !m_last_edge[s].compare_exchange_weak(
+                               last, key, std::memory_order_relaxed)) {
+                    }
+                }
+            }
+        });
+    detail::parallel_chunks(*m_pool, m_level.size(), m_grain,
+        [&](size_t task, size_t begin, size_t end) {
+            auto& ready = m_buffers[task];
+            for (auto i = begin; i < end; ++i) {
+                const auto successors = storage.out_edges(m_level[i]);
+                for (size_t j = 0; j < successors.size(); ++j) {
+                    const auto s = successors[j];
+                    if (m_pending[s].load(std::memory_order_relaxed) == 0
+                        && m_last_edge[s].load(std::memory_order_relaxed)
+                            == edge_key(m_scheduled + i, j)) {
+                        ready.push_back(s);
+                    }
+                }
+            }
+        });
+    gather();
+}
+
+template <typename GraphT>
+inline auto parallel_schedule_cursor<GraphT>::next_level() -> const view_t&
+{
+    if (is_done()) {
+        throw std::runtime_error("all jobs are done");
+    }
+    m_level.clear();
+    m_level.swap(m_ready);
+    m_remaining -= m_level.size();
+    if (m_level.size() < 2 * m_grain) {
+        release_sequential();
+    }
+    else {
+        release_parallel();
+    }
+    m_scheduled += m_level.size();
+    check_entry_point_exists();
+    return m_level;
+}
+
+template <typename GraphT>
+inline auto parallel_schedule_cursor<GraphT>::next_schedule()
+    -> std::vector<vertex_type>
+{
+    const auto& level = next_level();
+    std::vector<vertex_type> res;
+    res.reserve(level.size());
+    for (auto id : level) {
+        res.push_back(vertex_at(id));
+    }
+    return res;
+}
+
+template <typename GraphT>
+inline auto parallel_schedule_cursor<GraphT>::get_full_schedule()
+    -> std::vector<std::vector<vertex_type>>
+{
+    std::vector<std::vector<vertex_type>> res;
+    while (!is_done()) {
+        res.push_back(next_schedule());
+    }
+    return res;
+}
+
+} // namespace job_sheduler
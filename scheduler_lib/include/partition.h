@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+#include <graph_storage.h>
+#include <vertex_index.h>
+
+namespace job_sheduler {
+
+/// \brief the jobs of one level that a part of a partitioned graph runs
+struct partition_step {
+    // depth of the level, 0 based
+    size_t level{};
+    // jobs of other parts that have to be done before the jobs of the step
+    // can run, every job is waited for once by a part, at its first step
+    // depending on it
+    std::vector<vertex_id> wait_for;
+    std::vector<vertex_id> jobs;
+    // jobs of the step other parts wait for, to be announced when the step
+    // is done
+    std::vector<vertex_id> notify;
+};
+
+/// \brief assignment of the jobs of a graph to parts, e.g. worker nodes,
+/// and the schedule of every part
+///
+/// a part runs its steps in order. Waiting only ever is for jobs of
+/// earlier levels, so the parts can't deadlock as long as every part
+/// announces the notify jobs of a step once it is done.
+struct graph_partition {
+    static constexpr size_t no_part = static_cast<size_t>(-1);
+
+    // part of every vertex id, no_part for removed vertices
+    std::vector<size_t> part_of;
+    // steps of every part
+    std::vector<std::vector<partition_step>> schedules;
+    // edges between different parts
+    size_t cut_edges{};
+
+    size_t num_parts() const noexcept { return schedules.size(); }
+
+    /// \brief number of jobs of the part
+    size_t size(size_t part) const noexcept
+    {
+        return static_cast<size_t>(
+            std::count(part_of.begin(), part_of.end(), part));
+    }
+};
+
+namespace detail {
+
+// levels of the vertices that are not removed, in the order of
+// graph::next_level, throws if the graph has a cycle
+template <typename GraphT>
+void partition_levels(const GraphT& graph, std::vector<vertex_id>& order,
+    std::vector<size_t>& level)
+{
+    const auto& storage = graph.storage();
+    const auto n = storage.size();
+    std::vector<size_t> pending(n);
+    size_t num_active = 0;
+    level.assign(n, 0);
+    order.clear();
+    order.reserve(n);
+    for (vertex_id id = 0; id < n; ++id) {
+        if (graph.state(id) == vertex_state::removed) {
+            continue;
+        }
+        ++num_active;
+        pending[id] = storage.in_edges(id).size();
+        if (pending[id] == 0) {
+            order.push_back(id);
+        }
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        const auto v = order[i];
+        for (auto s : storage.out_edges(v)) {
+            level[s] = std::max(level[s], level[v] + 1);
+            if (--pending[s] == 0) {
+                order.push_back(s);
+            }
+        }
+    }
+    if (order.size() != num_active) {
+        throw std::runtime_error("cycle in job graph");
+    }
+}
+
+} // namespace detail
+
+/// \brief splits the jobs of the graph into num_parts parts with few
+/// dependencies between the parts
+///
+/// every level is split evenly, so the parts can run their jobs of a
+/// level at the same time: a part gets at most
+/// ceil(width / num_parts * (1 + max_imbalance)) jobs of a level of the
+/// given width, max_imbalance has to be at least 0. The jobs are assigned
+/// level by level to the part holding most of their predecessors, then
+/// refinement passes move jobs to the part holding most of their
+/// neighbours as long as that cuts fewer edges. The whole graph is
+/// partitioned regardless of its scheduling state, removed vertices are
+/// not part of any part.
+template <typename GraphT>
+graph_partition partition_graph(
+    const GraphT& graph, size_t num_parts, double max_imbalance = 0.1)
+{
+    constexpr size_t max_passes = 8;
+    if (num_parts == 0) {
+        throw std::invalid_argument("partition into 0 parts");
+    }
+    if (!(max_imbalance >= 0)) {
+        throw std::invalid_argument("negative partition imbalance");
+    }
+    const auto& storage = graph.storage();
+    std::vector<vertex_id> order;
+    std::vector<size_t> level;
+    detail::partition_levels(graph, order, level);
+
+    graph_partition res;
+    res.part_of.assign(storage.size(), graph_partition::no_part);
+    res.schedules.resize(num_parts);
+    const auto num_levels = order.empty() ? 0 : level[order.back()] + 1;
+    std::vector<size_t> capacity(num_levels);
+    for (auto v : order) {
+        ++capacity[level[v]];
+    }
+    for (auto& c : capacity) {
+        const auto even = static_cast<double>(c) / num_parts;
+        // a part never needs more than the whole level
+        c = std::max<size_t>(1,
+            static_cast<size_t>(std::ceil(std::min(
+                even * (1 + max_imbalance), static_cast<double>(c)))));
+    }
+    // jobs of every part per level
+    std::vector<size_t> load(num_levels * num_parts);
+    std::vector<size_t> count(num_parts);
+    const auto best_part = [&](vertex_id v, size_t current) {
+        const auto* level_load = &load[level[v] * num_parts];
+        auto best = current;
+        for (size_t p = 0; p < num_parts; ++p) {
+            if (p == current || level_load[p] >= capacity[level[v]]) {
+                continue;
+            }
+            if (best == graph_partition::no_part || count[p] > count[best]
+                || (count[p] == count[best]
+                       && level_load[p] < level_load[best])) {
+                best = p;
+            }
+        }
+        return best;
+    };
+    const auto count_parts = [&](auto edges) {
+        std::fill(count.begin(), count.end(), 0);
+        for (auto u : edges) {
+            const auto p = res.part_of[u];
+            if (p != graph_partition::no_part) {
+                ++count[p];
+            }
+        }
+    };
+
+    for (auto v : order) {
+        count_parts(storage.in_edges(v));
+        const auto p = best_part(v, graph_partition::no_part);
+        res.part_of[v] = p;
+        ++load[level[v] * num_parts + p];
+    }
+    for (size_t pass = 0; pass < max_passes; ++pass) {
+        bool moved = false;
+        for (auto v : order) {
+            count_parts(storage.in_edges(v));
+            for (auto s : storage.out_edges(v)) {
+                ++count[res.part_of[s]];
+            }
+            const auto current = res.part_of[v];
+            const auto p = best_part(v, current);
+            if (count[p] > count[current]) {
+                --load[level[v] * num_parts + current];
+                ++load[level[v] * num_parts + p];
+                res.part_of[v] = p;
+                moved = true;
+            }
+        }
+        if (!moved) {
+            break;
+        }
+    }
+
+    // the schedules are built part by part, so a part waits for a job of
+    // another part once
+    std::vector<std::vector<vertex_id>> members(num_parts);
+    for (auto v : order) {
+        members[res.part_of[v]].push_back(v);
+    }
+    std::vector<size_t> waited(storage.size(), graph_partition::no_part);
+    for (size_t p = 0; p < num_parts; ++p) {
+        auto& steps = res.schedules[p];
+        for (auto v : members[p]) {
+            if (steps.empty() || steps.back().level != level[v]) {
+                steps.push_back(partition_step{ level[v], {}, {}, {} });
+            }
+            auto& step = steps.back();
+            step.jobs.push_back(v);
+            for (auto u : storage.in_edges(v)) {
+                if (res.part_of[u] != p && waited[u] != p) {
+                    step.wait_for.push_back(u);
+                    waited[u] = p;
+                }
+            }
+            for (auto s : storage.out_edges(v)) {
+                if (res.part_of[s] != p) {
+                    ++res.cut_edges;
+                    if (step.notify.empty() || step.notify.back() != v) {
+                        step.notify.push_back(v);
+                    }
+                }
+            }
+        }
+    }
+    return res;
+}
+
+/// \brief writes the steps of every part, one line per step:
+/// \verbatim
+///  Part 1
+///  <level> wait <jobs> run <jobs> notify <jobs>
+/// \endverbatim
+/// levels count from 1 like the depth of the level schedule, empty lists
+/// are left out
+template <typename GraphT>
+void write_partition(
+    std::ostream& os, const GraphT& graph, const graph_partition& partition)
+{
+    const auto write_jobs = [&](const char* name, const auto& jobs) {
+        if (jobs.empty()) {
+            return;
+        }
+        os << ' ' << name << ' ';
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            os << (i == 0 ? "" : ",") << graph.vertex_at(jobs[i]);
+        }
+    };
+    for (size_t p = 0; p < partition.num_parts(); ++p) {
+        os << "Part " << p + 1 << '\n';
+        for (const auto& step : partition.schedules[p]) {
+            os << step.level + 1;
+            write_jobs("wait", step.wait_for);
+            write_jobs("run", step.jobs);
+            write_jobs("notify", step.notify);
+            os << '\n';
+        }
+    }
+    os << "Cut edges " << partition.cut_edges << '\n';
+}
+
+} // namespace job_sheduler
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace job_sheduler {
+
+/// \brief wall time and allocations of one phase of a run, a phase that is
+/// measured several times (e.g. per level) is accumulated
+struct phase_stats {
+    std::string name;
+    std::chrono::duration<double, std::milli> time{};
+    size_t allocations{};
+    // number of times the phase was measured
+    size_t count{};
+};
+
+/// \brief peak resident set size of the process in KiB
+inline size_t peak_rss_kb() noexcept
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss);
+}
+
+/// \brief statistics of a scheduling run: time per phase, size of the
+/// graph and of its schedule, allocations and peak memory
+///
+/// phases are timed by measure, which also reports every measurement to
+/// the callbacks registered with on_phase, e.g. to feed a metrics system.
+/// The library can't count allocations on its own, the application
+/// provides the count, e.g. from a replaced operator new; without one the
+/// allocations are reported as 0.
+class run_stats {
+public:
+    using allocation_counter = std::function<size_t()>;
+    using phase_callback = std::function<void(
+        std::string_view phase, std::chrono::duration<double, std::milli>)>;
+
+    explicit run_stats(allocation_counter allocations = {})
+        : m_allocations(std::move(allocations))
+        , m_initial_allocations(allocations_now())
+    {
+    }
+
+    /// \brief f is invoked after every measurement of a phase, it must not
+    /// throw
+    void on_phase(phase_callback f) { m_callbacks.push_back(std::move(f)); }
+
+    /// \brief runs f and adds its wall time and allocations to the phase,
+    /// returns the result of f
+    template <typename F>
+    decltype(auto) measure(std::string_view phase, F&& f);
+
+    /// \brief vertices and edges of the scheduled graph
+    void set_graph_size(size_t num_vertices, size_t num_edges) noexcept
+    {
+        m_num_vertices = num_vertices;
+        m_num_edges = num_edges;
+    }
+
+    /// \brief adds a level of the schedule with width vertices
+    void add_level(size_t width) noexcept
+    {
+        ++m_num_levels;
+        m_max_level_width = std::max(m_max_level_width, width);
+    }
+
+    const std::vector<phase_stats>& phases() const noexcept
+    {
+        return m_phases;
+    }
+
+    size_t num_vertices() const noexcept { return m_num_vertices; }
+    size_t num_edges() const noexcept { return m_num_edges; }
+    size_t num_levels() const noexcept { return m_num_levels; }
+    size_t max_level_width() const noexcept { return m_max_level_width; }
+
+    /// \brief allocations since the stats were created
+    size_t allocations() const
+    {
+        return allocations_now() - m_initial_allocations;
+    }
+
+    /// \brief human readable report
+    void write_text(std::ostream& os) const;
+
+    /// \brief the report as a single json object
+    void write_json(std::ostream& os) const;
+
+private:
+    size_t allocations_now() const
+    {
+        return m_allocations ? m_allocations() : 0;
+    }
+
+    phase_stats& phase(std::string_view name);
+
+    allocation_counter m_allocations;
+    size_t m_initial_allocations{};
+    std::vector<phase_callback> m_callbacks;
+    std::vector<phase_stats> m_phases;
+    size_t m_num_vertices{};
+    size_t m_num_edges{};
+    size_t m_num_levels{};
+    size_t m_max_level_width{};
+};
+
+template <typename F>
+inline decltype(auto) run_stats::measure(std::string_view name, F&& f)
+{
+    // the phase is updated on every exit of f, also when it throws
+    struct measurement {
+        run_stats& stats;
+        std::string_view name;
+        size_t allocations = stats.allocations_now();
+        std::chrono::steady_clock::time_point start
+            = std::chrono::steady_clock::now();
+
+        ~measurement()
+        {
+            const std::chrono::duration<double, std::milli> time
+                = std::chrono::steady_clock::now() - start;
+            auto& p = stats.phase(name);
+            p.time += time;
+            p.allocations += stats.allocations_now() - allocations;
+            ++p.count;
+            for (const auto& f : stats.m_callbacks) {
+                f(name, time);
+            }
+        }
+    };
+    measurement m{ *this, name };
+    return std::forward<F>(f)();
+}
+
+inline phase_stats& run_stats::phase(std::string_view name)
+{
+    const auto it = std::find_if(m_phases.begin(), m_phases.end(),
+        [name](const phase_stats& p) { return p.name == name; });
+    if (it != m_phases.end()) {
+        return *it;
+    }
+    m_phases.push_back(phase_stats{ std::string(name) });
+    return m_phases.back();
+}
+
+inline void run_stats::write_text(std::ostream& os) const
+{
+    constexpr auto field_size = 25;
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+    os << std::left << std::setw(field_size) << "Phase" << ' '
+       << std::setw(field_size) << "Time [ms]" << "Allocations" << '\n'
+       << std::setfill('=') << std::setw(3 * field_size) << '='
+       << std::setfill(' ') << '\n'
+       << std::fixed << std::setprecision(3);
+    for (const auto& p : m_phases) {
+        os << std::setw(field_size) << p.name << ' ' << std::setw(field_size)
+           << p.time.count() << p.allocations << '\n';
+    }
+    os << '\n'
+       << std::setw(field_size) << "Vertices" << m_num_vertices << '\n'
+       << std::setw(field_size) << "Edges" << m_num_edges << '\n'
+       << std::setw(field_size) << "Levels" << m_num_levels << '\n'
+       << std::setw(field_size) << "Max level width" << m_max_level_width
+       << '\n'
+       << std::setw(field_size) << "Allocations" << allocations() << '\n'
+       << std::setw(field_size) << "Peak RSS [KiB]" << peak_rss_kb() << '\n';
+    os.flags(flags);
+    os.precision(precision);
+}
+
+inline void run_stats::write_json(std::ostream& os) const
+{
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+    os << std::fixed << std::setprecision(3) << "{\"phases\":[";
+    for (size_t i = 0; i < m_phases.size(); ++i) {
+        const auto& p = m_phases[i];
+        // phase names are identifiers chosen by the application
+        os << (i == 0 ? "" : ",") << "{\"name\":\"" << p.name
+           << "\",\"ms\":" << p.time.count()
+           << ",\"allocations\":" << p.allocations << '}';
+    }
+    os << "],\"vertices\":" << m_num_vertices << ",\"edges\":" << m_num_edges
+       << ",\"levels\":" << m_num_levels
+       << ",\"max_level_width\":" << m_max_level_width
+       << ",\"allocations\":" << allocations()
+       << ",\"peak_rss_kb\":" << peak_rss_kb() << "}\n";
+    os.flags(flags);
+    os.precision(precision);
+}
+
+} // namespace job_sheduler
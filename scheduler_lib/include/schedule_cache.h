@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <unistd.h>
+
+#include <content_hash.h>
+#include <input_buffer.h>
+
+namespace job_sheduler {
+
+/// \brief directory of schedules keyed by the content of their input
+///
+/// an entry is named after the format_version of the cache, the
+/// content_hash and the size of the input text and a variant of the output
+/// (e.g. its format), so a repeated run on the same input only hashes it.
+/// An entry holds the input text followed by the schedule, a lookup
+/// compares the text, so inputs of the same hash never get the schedule of
+/// each other. Entries are written to a temporary file in the directory
+/// and renamed when they are complete, the rename is atomic, so any number
+/// of processes can share a cache: readers see either no entry or a
+/// complete one, concurrent writers of an entry write the same content and
+/// the last rename wins.
+class schedule_cache {
+public:
+    /// \brief part of every entry name, has to change whenever the content
+    /// of the entries (e.g. the output or the order of the schedule)
+    /// changes, so entries of older programs are not served
+    static constexpr std::string_view format_version = "v1";
+
+    /// \brief the schedule of a cache entry
+    class entry {
+    public:
+        entry(utils::input_buffer buffer, size_t text_size) noexcept
+            : m_buffer(std::move(buffer))
+            , m_text_size(text_size)
+        {
+        }
+
+        std::string_view schedule() const noexcept
+        {
+            return m_buffer.view().substr(m_text_size);
+        }
+
+    private:
+        utils::input_buffer m_buffer;
+        size_t m_text_size;
+    };
+
+    /// \brief the directory is created if it does not exist
+    explicit schedule_cache(std::filesystem::path dir)
+        : m_dir(std::move(dir))
+    {
+        std::filesystem::create_directories(m_dir);
+    }
+
+    const std::filesystem::path& dir() const noexcept { return m_dir; }
+
+    /// \brief path of the entry of the input text, variant has to be
+    /// usable in a file name
+    std::filesystem::path entry_path(
+        std::string_view text, std::string_view variant) const
+    {
+        return m_dir
+            / (std::string(format_version) + '-' + to_hex(content_hash(text))
+                  + '-' + std::to_string(text.size()) + std::string(variant));
+    }
+
+    /// \brief the entry at path if it was stored for text, nullopt if there
+    /// is none or it is of another text
+    static std::optional<entry> find(
+        const std::filesystem::path& path, std::string_view text)
+    {
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(path, ec)) {
+            return std::nullopt;
+        }
+        auto buffer = utils::input_buffer::map_file(path.string());
+        if (buffer.view().substr(0, text.size()) != text) {
+            return std::nullopt;
+        }
+        return entry(std::move(buffer), text.size());
+    }
+
+    /// \brief stores text and what write(std::ostream&) writes as the entry
+    /// at path, there is no entry if write throws
+    ///
+    /// text is written before write is called, so write may release it.
+    /// The returned entry is the one written, even if another process
+    /// replaces or removes the file afterwards.
+    template <typename WriteF>
+    static entry store(const std::filesystem::path& path,
+        std::string_view text, WriteF&& write);
+
+private:
+    std::filesystem::path m_dir;
+};
+
+template <typename WriteF>
+inline schedule_cache::entry schedule_cache::store(
+    const std::filesystem::path& path, std::string_view text, WriteF&& write)
+{
+    // unique among the processes and threads writing to the cache
+    static std::atomic<unsigned> counter{ 0 };
+    const auto text_size = text.size();
+    auto temp = path;
+    temp += ".tmp." + std::to_string(::getpid()) + '.'
+        + std::to_string(counter++);
+    try {
+        {
+            std::ofstream os(temp, std::ios::binary);
+            if (!os) {
+                throw std::runtime_error(
+                    "can't create cache entry " + temp.string());
+            }
+            os.write(text.data(), static_cast<std::streamsize>(text_size));
+            write(os);
+            os.flush();
+            if (!os) {
+                throw std::runtime_error(
+                    "can't write cache entry " + temp.string());
+            }
+        }
+        // the mapping outlives a later rename or removal of the file
+        entry res(utils::input_buffer::map_file(temp.string()), text_size);
+        std::filesystem::rename(temp, path);
+        return res;
+    }
+    catch (...) {
+        std::error_code ec;
+        std::filesystem::remove(temp, ec);
+        throw;
+    }
+}
+
+} // namespace job_sheduler
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+
+#include <graph_storage.h>
+#include <vertex_index.h>
+
+namespace job_sheduler {
+
+/// \brief schedules a graph without modifying it
+///
+/// the cursor starts at the current scheduling state of the graph and owns
+/// the state of its own scheduling, the graph is only read. Any number of
+/// cursors can run on the same graph, also concurrently, as long as the
+/// graph is not modified while they are used. Its interface is the one of
+/// the scheduling part of graph, e.g. schedule_levels works on cursors too.
+template <typename GraphT>
+class schedule_cursor {
+public:
+    using vertex_type = typename GraphT::vertex_type;
+    using view_t = std::vector<vertex_id>;
+
+    explicit schedule_cursor(const GraphT& graph);
+
+    /// \brief number of vertices not scheduled by the cursor yet
+    size_t num_vertices() const noexcept { return m_remaining; }
+
+    bool is_done() const noexcept { return m_remaining == 0; }
+
+    const vertex_type& vertex_at(vertex_id id) const noexcept
+    {
+        return m_graph->vertex_at(id);
+    }
+
+    /// \brief see graph::next_level
+    const view_t& next_level();
+
+    std::vector<vertex_type> next_schedule();
+
+    std::vector<std::vector<vertex_type>> get_full_schedule();
+
+private:
+    // same errors as the graph: a cycle is reported as soon as nothing is
+    // ready anymore
+    void check_entry_point_exists() const
+    {
+        if (m_remaining != 0 && m_ready.empty()) {
+            throw std::runtime_error("no entry point in graph");
+        }
+    }
+
+    const GraphT* m_graph;
+    view_t m_ready;
+    view_t m_level;
+    std::vector<size_t> m_pending;
+    size_t m_remaining{};
+};
+
+template <typename GraphT>
+inline schedule_cursor<GraphT>::schedule_cursor(const GraphT& graph)
+    : m_graph(&graph)
+{
+    const auto& storage = graph.storage();
+    const auto active = [&](vertex_id id) {
+        const auto state = graph.state(id);
+        return state == vertex_state::pending || state == vertex_state::ready;
+    };
+    m_pending.resize(storage.size());
+    for (vertex_id id = 0; id < storage.size(); ++id) {
+        if (!active(id)) {
+            continue;
+        }
+        ++m_remaining;
+        for (auto p : storage.in_edges(id)) {
+            m_pending[id] += active(p) ? 1 : 0;
+        }
+        if (m_pending[id] == 0) {
+            m_ready.push_back(id);
+        }
+    }
+    check_entry_point_exists();
+}
+
+template <typename GraphT>
+inline auto schedule_cursor<GraphT>::next_level() -> const view_t&
+{
+    if (is_done()) {
+        throw std::runtime_error("all jobs are done");
+    }
+    m_level.clear();
+    m_level.swap(m_ready);
+    m_remaining -= m_level.size();
+    for (auto v : m_level) {
+        for (auto s : m_graph->storage().out_edges(v)) {
+            if (--m_pending[s] == 0) {
+                m_ready.push_back(s);
+            }
+        }
+    }
+    check_entry_point_exists();
+    return m_level;
+}
+
+template <typename GraphT>
+inline auto schedule_cursor<GraphT>::next_schedule()
+    -> std::vector<vertex_type>
+{
+    const auto& level = next_level();
+    std::vector<vertex_type> res;
+    res.reserve(level.size());
+    for (auto id : level) {
+        res.push_back(vertex_at(id));
+    }
+    return res;
+}
+
+template <typename GraphT>
+inline auto schedule_cursor<GraphT>::get_full_schedule()
+    -> std::vector<std::vector<vertex_type>>
+{
+    std::vector<std::vector<vertex_type>> res;
+    while (!is_done()) {
+        res.push_back(next_schedule());
+    }
+    return res;
+}
+
+} // namespace job_sheduler
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include <graph_storage.h>
+#include <vertex_index.h>
+
+namespace job_sheduler {
+
+/// \brief lazy input range of the levels of a graph's schedule
+///
+/// every increment schedules one more level of the graph (see
+/// graph::next_level), nothing is materialized up front. A level is a view
+/// of the graph's vertices, no payload is copied, it is valid until the
+/// range is advanced. Scheduling errors (e.g. a cycle) are thrown by
+/// begin() or by the increment that reaches them.
+template <typename GraphT>
+class schedule_range {
+public:
+    using vertex_type = typename GraphT::vertex_type;
+
+    /// \brief vertices of one level of the schedule
+    class level {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = vertex_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const vertex_type*;
+            using reference = const vertex_type&;
+
+            iterator() = default;
+            iterator(const GraphT* graph, id_range::iterator it)
+                : m_graph(graph)
+                , m_it(it)
+            {
+            }
+            reference operator*() const { return m_graph->vertex_at(*m_it); }
+            pointer operator->() const { return &**this; }
+            iterator& operator++()
+            {
+                ++m_it;
+                return *this;
+            }
+            iterator operator++(int)
+            {
+                auto res = *this;
+                ++m_it;
+                return res;
+            }
+            bool operator==(const iterator& other) const
+            {
+                return m_it == other.m_it;
+            }
+            bool operator!=(const iterator& other) const
+            {
+                return m_it != other.m_it;
+            }
+
+        private:
+            const GraphT* m_graph{};
+            id_range::iterator m_it{};
+        };
+
+        level(const GraphT* graph, id_range ids, size_t depth)
+            : m_graph(graph)
+            , m_ids(ids)
+            , m_depth(depth)
+        {
+        }
+
+        iterator begin() const { return iterator(m_graph, m_ids.begin()); }
+        iterator end() const { return iterator(m_graph, m_ids.end()); }
+        size_t size() const noexcept { return m_ids.size(); }
+        bool empty() const noexcept { return m_ids.empty(); }
+        /// \brief ids of the vertices of the level
+        id_range ids() const noexcept { return m_ids; }
+        /// \brief 1 based depth of the level in the schedule
+        size_t depth() const noexcept { return m_depth; }
+
+    private:
+        const GraphT* m_graph;
+        id_range m_ids;
+        size_t m_depth;
+    };
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = level;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const level*;
+        using reference = const level&;
+
+        iterator() = default;
+        explicit iterator(schedule_range* range)
+            : m_range(range)
+        {
+        }
+        reference operator*() const { return m_range->m_level; }
+        pointer operator->() const { return &m_range->m_level; }
+        iterator& operator++()
+        {
+            m_range->advance();
+            return *this;
+        }
+        void operator++(int) { m_range->advance(); }
+        // all iterators that are not at the end compare equal, like for
+        // std::istream_iterator
+        bool operator==(const iterator& other) const
+        {
+            return at_end() == other.at_end();
+        }
+        bool operator!=(const iterator& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        bool at_end() const { return !m_range || m_range->m_at_end; }
+
+        schedule_range* m_range{};
+    };
+
+    explicit schedule_range(GraphT& graph)
+        : m_graph(&graph)
+        , m_level(&graph, {}, 0)
+    {
+    }
+
+    /// \brief schedules the first level, call it once
+    iterator begin()
+    {
+        advance();
+        return iterator(this);
+    }
+
+    iterator end() { return iterator(); }
+
+private:
+    void advance()
+    {
+        if (m_graph->is_done()) {
+            m_at_end = true;
+            return;
+        }
+        const auto& ids = m_graph->next_level();
+        m_level = level(m_graph, detail::to_range(ids), m_level.depth() + 1);
+    }
+
+    GraphT* m_graph;
+    level m_level;
+    bool m_at_end{};
+};
+
+/// \brief lazy schedule of graph, see schedule_range
+template <typename GraphT>
+schedule_range<GraphT> schedule_levels(GraphT& graph)
+{
+    return schedule_range<GraphT>(graph);
+}
+
+/// \brief throws like scheduling the graph if it has a cycle
+///
+/// one O(V + E) pass over the graph without changing it, so a schedule
+/// streamed by schedule_levels can be checked before any level of it is
+/// written. Removed vertices are ignored.
+template <typename GraphT>
+void check_acyclic(const GraphT& graph)
+{
+    const auto& storage = graph.storage();
+    const auto n = storage.size();
+    std::vector<size_t> pending(n);
+    std::vector<vertex_id> ready;
+    size_t num_active = 0;
+    for (vertex_id id = 0; id < n; ++id) {
+        if (graph.state(id) == vertex_state::removed) {
+            continue;
+        }
+        ++num_active;
+        pending[id] = storage.in_edges(id).size();
+        if (pending[id] == 0) {
+            ready.push_back(id);
+        }
+    }
+    size_t num_released = 0;
+    while (!ready.empty()) {
+        const auto v = ready.back();
+        ready.pop_back();
+        ++num_released;
+        for (auto s : storage.out_edges(v)) {
+            if (--pending[s] == 0) {
+                ready.push_back(s);
+            }
+        }
+    }
+    if (num_released != num_active) {
+        throw std::runtime_error("cycle in job graph");
+    }
+}
+
+} // namespace job_sheduler
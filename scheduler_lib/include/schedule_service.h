@@ -0,0 +1,382 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include <content_hash.h>
+#include <graph_storage.h>
+#include <job_graph.h>
+#include <schedule_cursor.h>
+#include <schedule_range.h>
+#include <schedule_writer.h>
+#include <simplified_dot_parser.h>
+
+namespace job_sheduler {
+
+/// \brief parsed graph kept by the schedule_service, the labels point into
+/// its own copy of the text
+class cached_graph {
+public:
+    using graph_type = graph<std::string_view, csr_storage>;
+
+    explicit cached_graph(std::string text)
+        : m_text(std::move(text))
+        , m_graph(build(m_text))
+        , m_size_in_bytes(
+              sizeof(cached_graph) + m_text.capacity() + m_graph.memory_usage())
+    {
+    }
+
+    cached_graph(const cached_graph&) = delete;
+
+    cached_graph& operator=(const cached_graph&) = delete;
+
+    /// \brief the graph as parsed, it is never scheduled, use
+    /// schedule_cursor to schedule it
+    const graph_type& get() const noexcept { return m_graph; }
+
+    /// \brief the text the graph was parsed from
+    std::string_view text() const noexcept { return m_text; }
+
+    /// \brief bytes of the text and of the graph with its index and the
+    /// state of its vertices (see graph::memory_usage), the size charged to
+    /// the cache of the schedule_service
+    size_t size_in_bytes() const noexcept { return m_size_in_bytes; }
+
+private:
+    static graph_type build(std::string_view text)
+    {
+        const auto edges = utils::parse_simplified_dot(text);
+        return make_graph<csr_storage>(edges.cbegin(), edges.cend());
+    }
+
+    std::string m_text;
+    graph_type m_graph;
+    size_t m_size_in_bytes;
+};
+
+/// \brief request of the schedule_service protocol, see schedule_service
+struct service_request {
+    enum class command { graph, schedule, run, lookup };
+
+    command cmd{};
+    // the graph of schedule and lookup
+    std::uint64_t hash{};
+    schedule_format format{ schedule_format::table };
+    // size of the dot text following the request line of graph and run
+    size_t body_size{};
+};
+
+/// \brief schedules dot graphs on request, parsed graphs are cached by the
+/// content hash of their text
+///
+/// the protocol is independent of the transport, a request is a line
+/// optionally followed by a body of the given size:
+/// \verbatim
+///  GRAPH <size>\n<dot text>        -> OK <hash>\n
+///  SCHEDULE <hash> [<format>]\n    -> OK <size>\n<schedule>
+///  RUN <size> [<format>]\n<dot>    -> OK <size>\n<schedule>
+///  LOOKUP <hash>\n                 -> OK <#vertices> <#edges>\n
+/// \endverbatim
+/// format is one of schedule_format (default table), RUN is GRAPH and
+/// SCHEDULE in one, the text is hashed and only parsed if it is not in the
+/// cache. Errors are answered with ERR <message>\n, the connection can be
+/// used for further requests.
+///
+/// all members can be called concurrently. A cached graph is never
+/// modified, every schedule is computed by its own schedule_cursor. The
+/// cache holds graphs of at most cache_size bytes in total, see
+/// cached_graph::size_in_bytes, the least recently used graphs are dropped
+/// to make room for a new one. Requests using a dropped graph keep it alive
+/// until they are done, a graph larger than the whole cache is answered
+/// but not kept.
+///
+/// bodies are read completely before they are parsed, a server answering
+/// n clients at a time holds up to n times max_body_size bytes of requests
+/// in addition to the cache
+class schedule_service {
+public:
+    static constexpr size_t default_cache_size = size_t{ 1 } << 30;
+    static constexpr size_t default_max_body_size = size_t{ 16 } << 20;
+
+    explicit schedule_service(size_t cache_size = default_cache_size,
+        size_t max_body_size = default_max_body_size)
+        : m_cache_size(cache_size)
+        , m_max_body_size(max_body_size)
+    {
+    }
+
+    /// \brief parses a request line without the new line, throws
+    /// std::invalid_argument for malformed requests and bodies larger than
+    /// max_body_size
+    static service_request parse_request(std::string_view line,
+        size_t max_body_size = default_max_body_size);
+
+    /// \brief largest body accepted, pass it to parse_request
+    size_t max_body_size() const noexcept { return m_max_body_size; }
+
+    /// \brief answers the request, body is the text following the request
+    /// line, errors are returned as ERR responses
+    std::string respond(const service_request& request, std::string_view body);
+
+    /// \brief graph of the text, parsed unless it is in the cache already
+    ///
+    /// a cached graph of the same hash but another text is a collision of
+    /// the hash, the text is parsed and replaces it in the cache
+    std::pair<std::uint64_t, std::shared_ptr<const cached_graph>> add(
+        std::string_view text);
+
+    /// \brief cached graph of the hash, nullptr if there is none
+    std::shared_ptr<const cached_graph> find(std::uint64_t hash);
+
+    size_t size() const;
+
+    /// \brief bytes of the cached graphs, at most cache_size
+    size_t size_in_bytes() const;
+
+    /// \brief number of graphs that were parsed
+    size_t num_parsed() const;
+
+private:
+    struct entry {
+        std::shared_ptr<const cached_graph> graph;
+        std::uint64_t last_use{};
+    };
+
+    static std::string schedule(
+        const cached_graph& graph, schedule_format format);
+
+    void insert(std::uint64_t hash, std::shared_ptr<const cached_graph> graph);
+
+    void erase(std::unordered_map<std::uint64_t, entry>::iterator it);
+
+    size_t m_cache_size;
+    size_t m_max_body_size;
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::uint64_t, entry> m_graphs;
+    size_t m_size_in_bytes{};
+    std::uint64_t m_clock{};
+    size_t m_num_parsed{};
+};
+
+namespace detail {
+
+inline std::string_view next_word(std::string_view& s) noexcept
+{
+    s = utils::detail::trim_front(s);
+    const auto end = std::min(s.find(' '), s.size());
+    const auto res = s.substr(0, end);
+    s.remove_prefix(end);
+    return res;
+}
+
+inline size_t parse_size(std::string_view word)
+{
+    const std::string digits(word);
+    char* end = nullptr;
+    const auto res = std::strtoull(digits.c_str(), &end, 10);
+    if (digits.empty() || end != digits.c_str() + digits.size()
+        || digits.front() == '-') {
+        throw std::invalid_argument("invalid size: " + digits);
+    }
+    return static_cast<size_t>(res);
+}
+
+inline std::uint64_t parse_hash(std::string_view word)
+{
+    const auto res = parse_hex(word);
+    if (!res) {
+        throw std::invalid_argument("invalid hash: " + std::string(word));
+    }
+    return *res;
+}
+
+} // namespace detail
+
+inline service_request schedule_service::parse_request(
+    std::string_view line, size_t max_body_size)
+{
+    using command = service_request::command;
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    service_request res;
+    const auto name = detail::next_word(line);
+    if (name == "GRAPH") {
+        res.cmd = command::graph;
+        res.body_size = detail::parse_size(detail::next_word(line));
+    }
+    else if (name == "SCHEDULE") {
+        res.cmd = command::schedule;
+        res.hash = detail::parse_hash(detail::next_word(line));
+    }
+    else if (name == "RUN") {
+        res.cmd = command::run;
+        res.body_size = detail::parse_size(detail::next_word(line));
+    }
+    else if (name == "LOOKUP") {
+        res.cmd = command::lookup;
+        res.hash = detail::parse_hash(detail::next_word(line));
+    }
+    else {
+        throw std::invalid_argument("unknown request: " + std::string(name));
+    }
+    if (res.cmd == command::schedule || res.cmd == command::run) {
+        const auto format = detail::next_word(line);
+        if (!format.empty()) {
+            res.format = parse_schedule_format(format);
+        }
+    }
+    if (res.body_size > max_body_size) {
+        throw std::invalid_argument("request body too large");
+    }
+    if (!utils::detail::trim(line).empty()) {
+        throw std::invalid_argument(
+            "unexpected arguments: " + std::string(line));
+    }
+    return res;
+}
+
+inline std::string schedule_service::respond(
+    const service_request& request, std::string_view body)
+{
+    using command = service_request::command;
+    const auto with_size = [](const std::string& payload) {
+        return "OK " + std::to_string(payload.size()) + '\n' + payload;
+    };
+    try {
+        switch (request.cmd) {
+        case command::graph:
+            return "OK " + to_hex(add(body).first) + '\n';
+        case command::run:
+            return with_size(schedule(*add(body).second, request.format));
+        case command::schedule:
+        case command::lookup: {
+            const auto graph = find(request.hash);
+            if (!graph) {
+                return "ERR unknown graph " + to_hex(request.hash) + '\n';
+            }
+            if (request.cmd == command::schedule) {
+                return with_size(schedule(*graph, request.format));
+            }
+            return "OK " + std::to_string(graph->get().storage().size()) + ' '
+                + std::to_string(graph->get().num_edges()) + '\n';
+        }
+        }
+    }
+    catch (const std::exception& e) {
+        // a response is a single line, the message may contain a line of
+        // the dot text
+        std::string message(e.what());
+        for (auto& c : message) {
+            c = c == '\n' || c == '\r' ? ' ' : c;
+        }
+        return "ERR " + message + '\n';
+    }
+    return "ERR unknown request\n";
+}
+
+inline auto schedule_service::add(std::string_view text)
+    -> std::pair<std::uint64_t, std::shared_ptr<const cached_graph>>
+{
+    const auto hash = content_hash(text);
+    if (auto graph = find(hash); graph && graph->text() == text) {
+        return { hash, std::move(graph) };
+    }
+    // parsed without holding the lock, when the same graph is added
+    // concurrently the copy inserted last is kept
+    auto graph = std::make_shared<const cached_graph>(std::string(text));
+    insert(hash, graph);
+    return { hash, std::move(graph) };
+}
+
+inline auto schedule_service::find(std::uint64_t hash)
+    -> std::shared_ptr<const cached_graph>
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_graphs.find(hash);
+    if (it == m_graphs.end()) {
+        return nullptr;
+    }
+    it->second.last_use = ++m_clock;
+    return it->second.graph;
+}
+
+inline size_t schedule_service::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_graphs.size();
+}
+
+inline size_t schedule_service::size_in_bytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_size_in_bytes;
+}
+
+inline size_t schedule_service::num_parsed() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_num_parsed;
+}
+
+inline std::string schedule_service::schedule(
+    const cached_graph& graph, schedule_format format)
+{
+    // responses are small, the writer doesn't need a large buffer
+    constexpr size_t buffer_size = 4096;
+    schedule_cursor<cached_graph::graph_type> cursor(graph.get());
+    std::ostringstream oss;
+    schedule_writer writer(oss, format, buffer_size);
+    for (const auto& level : schedule_levels(cursor)) {
+        writer.write_level(level);
+    }
+    writer.finish();
+    return oss.str();
+}
+
+inline void schedule_service::insert(
+    std::uint64_t hash, std::shared_ptr<const cached_graph> graph)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_num_parsed;
+    if (const auto it = m_graphs.find(hash); it != m_graphs.end()) {
+        erase(it);
+    }
+    const auto size = graph->size_in_bytes();
+    if (size > m_cache_size) {
+        return;
+    }
+    while (m_size_in_bytes + size > m_cache_size) {
+        // evictions are rare compared to lookups, a linear scan is cheaper
+        // than keeping an order of use up to date on every lookup
+        auto lru = m_graphs.begin();
+        for (auto it = m_graphs.begin(); it != m_graphs.end(); ++it) {
+            if (it->second.last_use < lru->second.last_use) {
+                lru = it;
+            }
+        }
+        erase(lru);
+    }
+    m_size_in_bytes += size;
+    m_graphs.emplace(hash, entry{ std::move(graph), ++m_clock });
+}
+
+inline void schedule_service::erase(
+    std::unordered_map<std::uint64_t, entry>::iterator it)
+{
+    m_size_in_bytes -= it->second.graph->size_in_bytes();
+    m_graphs.erase(it);
+}
+
+} // namespace job_sheduler
@@ -0,0 +1,420 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace job_sheduler {
+
+/// \brief output formats of schedule_writer
+enum class schedule_format {
+    table, ///< the human readable table of the scheduler
+    csv, ///< one depth,vertex row per vertex
+    json, ///< {"levels":[["a","b"],["c"]]}
+    binary, ///< see binary_schedule_format
+};
+
+/// \brief parses the name of a schedule_format, e.g. "csv"
+inline schedule_format parse_schedule_format(std::string_view name)
+{
+    if (name == "table") {
+        return schedule_format::table;
+    }
+    if (name == "csv") {
+        return schedule_format::csv;
+    }
+    if (name == "json") {
+        return schedule_format::json;
+    }
+    if (name == "binary") {
+        return schedule_format::binary;
+    }
+    throw std::invalid_argument(
+        "invalid schedule format: " + std::string(name));
+}
+
+/// \brief file extension of a schedule written in format, e.g. ".csv"
+inline std::string_view schedule_file_extension(schedule_format format)
+{
+    switch (format) {
+    case schedule_format::csv:
+        return ".csv";
+    case schedule_format::json:
+        return ".json";
+    case schedule_format::binary:
+        return ".bin";
+    default:
+        return ".txt";
+    }
+}
+
+/// \brief binary schedule format
+///
+/// \verbatim
+///  header       magic, version, byte order mark
+///  per level    u32 #vertices, then per vertex u32 label size and label
+///  trailer      u32 0
+/// \endverbatim
+/// levels are never empty, so the trailer marks a complete schedule,
+/// numbers are stored in the byte order of the writer
+namespace binary_schedule_format {
+
+constexpr char magic[8] = { 'J', 'S', 'S', 'C', 'H', 'E', 'D', '\0' };
+constexpr std::uint32_t version = 1;
+constexpr std::uint32_t byte_order_mark = 0x01020304;
+
+struct header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order_mark;
+};
+
+} // namespace binary_schedule_format
+
+namespace utils {
+
+/// \brief buffered writer to an ostream
+///
+/// bytes are collected in a fixed size buffer and written with a single
+/// ostream::write when it is full, there is no per item formatting of the
+/// stream. Writes larger than the buffer bypass it. The destructor writes
+/// what is left in the buffer, errors are reported only by flush.
+class output_buffer {
+public:
+    static constexpr size_t default_size = 1 << 20;
+
+    explicit output_buffer(std::ostream& os, size_t size = default_size)
+        : m_os(os)
+    {
+        m_buffer.reserve(size == 0 ? 1 : size);
+    }
+
+    output_buffer(const output_buffer&) = delete;
+
+    output_buffer& operator=(const output_buffer&) = delete;
+
+    ~output_buffer()
+    {
+        try {
+            flush();
+        }
+        catch (...) {
+        }
+    }
+
+    void put(char c)
+    {
+        if (m_buffer.size() == m_buffer.capacity()) {
+            write_buffer();
+        }
+        m_buffer.push_back(c);
+    }
+
+    void append(std::string_view s)
+    {
+        if (m_buffer.size() + s.size() > m_buffer.capacity()) {
+            write_buffer();
+            if (s.size() > m_buffer.capacity()) {
+                write(s.data(), s.size());
+                return;
+            }
+        }
+        m_buffer.insert(m_buffer.end(), s.begin(), s.end());
+    }
+
+    /// \brief appends n copies of c
+    void fill(char c, size_t n)
+    {
+        for (; n != 0; --n) {
+            put(c);
+        }
+    }
+
+    template <typename T>
+    void append_number(T value)
+    {
+        static_assert(std::is_integral_v<T>);
+        char digits[24];
+        const auto res = std::to_chars(std::begin(digits), std::end(digits),
+            value);
+        append(std::string_view(digits, res.ptr - digits));
+    }
+
+    /// \brief appends the object representation of value
+    template <typename T>
+    void append_raw(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        append(std::string_view(
+            reinterpret_cast<const char*>(&value), sizeof(value)));
+    }
+
+    /// \brief writes the buffer and flushes the stream, throws if the
+    /// stream fails
+    void flush()
+    {
+        write_buffer();
+        m_os.flush();
+        if (!m_os) {
+            throw std::runtime_error("failed to write output");
+        }
+    }
+
+private:
+    void write_buffer()
+    {
+        write(m_buffer.data(), m_buffer.size());
+        m_buffer.clear();
+    }
+
+    void write(const char* data, size_t size)
+    {
+        if (size != 0) {
+            m_os.write(data, static_cast<std::streamsize>(size));
+        }
+    }
+
+    std::ostream& m_os;
+    std::vector<char> m_buffer;
+};
+
+} // namespace utils
+
+/// \brief writes a schedule level by level in one of the schedule_format
+///
+/// levels can be written as soon as they are scheduled, e.g. from
+/// schedule_levels, the format is completed by finish. Vertices have to
+/// be string like or integral, integral vertices are written as decimal
+/// labels. Output is buffered, what is written before an error (e.g. a
+/// cycle found while scheduling) is still written out on destruction.
+class schedule_writer {
+public:
+    explicit schedule_writer(std::ostream& os,
+        schedule_format format = schedule_format::table,
+        size_t buffer_size = utils::output_buffer::default_size);
+
+    /// \brief writes the next level, a range of vertices
+    template <typename LevelT>
+    void write_level(const LevelT& level);
+
+    /// \brief writes the end of the schedule and flushes the output
+    void finish();
+
+    /// \brief number of levels written
+    size_t depth() const noexcept { return m_depth; }
+
+private:
+    static constexpr size_t field_size = 25;
+
+    template <typename VertexT>
+    void write_label(const VertexT& v);
+
+    void write_csv_label(std::string_view label);
+    void write_json_label(std::string_view label);
+    void write_binary_label(std::string_view label);
+
+    utils::output_buffer m_out;
+    schedule_format m_format;
+    size_t m_depth{};
+};
+
+inline schedule_writer::schedule_writer(
+    std::ostream& os, schedule_format format, size_t buffer_size)
+    : m_out(os, buffer_size)
+    , m_format(format)
+{
+    switch (m_format) {
+    case schedule_format::table:
+        m_out.append("Depth");
+        m_out.fill(' ', field_size - 5);
+        m_out.append(" Independent vertices");
+        m_out.fill(' ', field_size - 20);
+        m_out.put('\n');
+        m_out.fill('=', 2 * field_size);
+        m_out.put('\n');
+        break;
+    case schedule_format::csv:
+        m_out.append("depth,vertex\n");
+        break;
+    case schedule_format::json:
+        m_out.append("{\"levels\":[");
+        break;
+    case schedule_format::binary: {
+        binary_schedule_format::header header{};
+        std::copy(std::begin(binary_schedule_format::magic),
+            std::end(binary_schedule_format::magic), header.magic);
+        header.version = binary_schedule_format::version;
+        header.byte_order_mark = binary_schedule_format::byte_order_mark;
+        m_out.append_raw(header);
+        break;
+    }
+    }
+}
+
+template <typename LevelT>
+inline void schedule_writer::write_level(const LevelT& level)
+{
+    ++m_depth;
+    switch (m_format) {
+    case schedule_format::table: {
+        size_t width = 1;
+        for (auto d = m_depth; d >= 10; d /= 10) {
+            ++width;
+        }
+        m_out.append_number(m_depth);
+        m_out.fill(' ', width < field_size ? field_size - width : 0);
+        for (const auto& v : level) {
+            write_label(v);
+            m_out.put(',');
+        }
+        m_out.put('\n');
+        break;
+    }
+    case schedule_format::csv:
+        for (const auto& v : level) {
+            m_out.append_number(m_depth);
+            m_out.put(',');
+            write_label(v);
+            m_out.put('\n');
+        }
+        break;
+    case schedule_format::json: {
+        m_out.append(m_depth == 1 ? "\n[" : ",\n[");
+        bool first = true;
+        for (const auto& v : level) {
+            if (!first) {
+                m_out.put(',');
+            }
+            first = false;
+            write_label(v);
+        }
+        m_out.put(']');
+        break;
+    }
+    case schedule_format::binary:
+        m_out.append_raw(static_cast<std::uint32_t>(level.size()));
+        for (const auto& v : level) {
+            write_label(v);
+        }
+        break;
+    }
+}
+
+inline void schedule_writer::finish()
+{
+    switch (m_format) {
+    case schedule_format::table:
+    case schedule_format::csv:
+        break;
+    case schedule_format::json:
+        m_out.append(m_depth == 0 ? "]}\n" : "\n]}\n");
+        break;
+    case schedule_format::binary:
+        m_out.append_raw(std::uint32_t{ 0 });
+        break;
+    }
+    m_out.flush();
+}
+
+template <typename VertexT>
+inline void schedule_writer::write_label(const VertexT& v)
+{
+    if constexpr (std::is_convertible_v<const VertexT&, std::string_view>) {
+        const std::string_view label(v);
+        switch (m_format) {
+        case schedule_format::table:
+            m_out.append(label);
+            break;
+        case schedule_format::csv:
+            write_csv_label(label);
+            break;
+        case schedule_format::json:
+            write_json_label(label);
+            break;
+        case schedule_format::binary:
+            write_binary_label(label);
+            break;
+        }
+    }
+    else {
+        static_assert(std::is_integral_v<VertexT>,
+            "vertices have to be string like or integral");
+        char digits[24];
+        const auto res
+            = std::to_chars(std::begin(digits), std::end(digits), v);
+        write_label(std::string_view(digits, res.ptr - digits));
+    }
+}
+
+// RFC 4180, fields with separators, quotes or line breaks are quoted
+inline void schedule_writer::write_csv_label(std::string_view label)
+{
+    if (label.find_first_of(",\"\r\n") == std::string_view::npos) {
+        m_out.append(label);
+        return;
+    }
+    m_out.put('"');
+    for (auto c : label) {
+        if (c == '"') {
+            m_out.put('"');
+        }
+        m_out.put(c);
+    }
+    m_out.put('"');
+}
+
+inline void schedule_writer::write_json_label(std::string_view label)
+{
+    constexpr char hex[] = "0123456789abcdef";
+    m_out.put('"');
+    for (auto c : label) {
+        const auto u = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            m_out.put('\\');
+            m_out.put(c);
+        }
+        else if (c == '\n') {
+            m_out.append("\\n");
+        }
+        else if (c == '\t') {
+            m_out.append("\\t");
+        }
+        else if (u < 0x20) {
+            m_out.append("\\u00");
+            m_out.put(hex[u >> 4]);
+            m_out.put(hex[u & 0xf]);
+        }
+        else {
+            m_out.put(c);
+        }
+    }
+    m_out.put('"');
+}
+
+inline void schedule_writer::write_binary_label(std::string_view label)
+{
+    m_out.append_raw(static_cast<std::uint32_t>(label.size()));
+    m_out.append(label);
+}
+
+/// \brief writes all levels of schedule (e.g. schedule_levels or
+/// graph::get_full_schedule) in the given format
+template <typename ScheduleT>
+void write_schedule(std::ostream& os, ScheduleT&& schedule,
+    schedule_format format = schedule_format::table)
+{
+    schedule_writer writer(os, format);
+    for (const auto& level : schedule) {
+        writer.write_level(level);
+    }
+    writer.finish();
+}
+
+} // namespace job_sheduler
@@ -1,13 +1,263 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <future>
 #include <istream>
-#include <regex>
+#include <iterator>
+#include <memory_resource>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
+
+#include <thread_pool.h>
 
 namespace job_sheduler {
 namespace utils {
 
+/// \brief edge of a dot file, the labels point into the parsed text
+using edge_view = std::pair<std::string_view, std::string_view>;
+
+namespace detail {
+
+// same characters as \s in std::regex
+constexpr bool is_space(char c) noexcept
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f'
+        || c == '\r';
+}
+
+inline std::string_view trim_front(std::string_view s) noexcept
+{
+    size_t i = 0;
+    while (i < s.size() && is_space(s[i])) {
+        ++i;
+    }
+    return s.substr(i);
+}
+
+inline std::string_view trim(std::string_view s) noexcept
+{
+    s = trim_front(s);
+    while (!s.empty() && is_space(s.back())) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+inline bool consume(std::string_view& s, std::string_view prefix) noexcept
+{
+    if (s.substr(0, prefix.size()) != prefix) {
+        return false;
+    }
+    s.remove_prefix(prefix.size());
+    return true;
+}
+
+// non empty label between double quotes
+inline bool consume_label(std::string_view& s, std::string_view& label)
+{
+    if (!consume(s, "\"")) {
+        return false;
+    }
+    const auto end = s.find('"');
+    if (end == 0 || end == std::string_view::npos) {
+        return false;
+    }
+    label = s.substr(0, end);
+    s.remove_prefix(end + 1);
+    return true;
+}
+
+inline bool is_empty_line(std::string_view line) noexcept
+{
+    return trim(line).empty();
+}
+
+// digraph <name> {, unlike in the regex based parser the name may be
+// empty or longer than one character
+inline bool is_start_line(std::string_view line) noexcept
+{
+    line = trim(line);
+    if (!consume(line, "digraph") || line.empty() || !is_space(line.front())
+        || line.back() != '{') {
+        return false;
+    }
+    line.remove_suffix(1);
+    return trim(line).find('{') == std::string_view::npos;
+}
+
+// "from" -> "to"; at the start of line
+inline bool parse_edge(std::string_view line, edge_view& edge) noexcept
+{
+    if (!consume_label(line, edge.first)) {
+        return false;
+    }
+    line = trim_front(line);
+    if (!consume(line, "->")) {
+        return false;
+    }
+    line = trim_front(line);
+    if (!consume_label(line, edge.second)) {
+        return false;
+    }
+    line = trim_front(line);
+    return consume(line, ";");
+}
+
+// "from" -> "to"; anywhere in the line, like std::regex_search did in the
+// regex based parser: the first quote starting an edge wins, the text
+// before and after the edge is ignored
+inline bool parse_edge_line(std::string_view line, edge_view& edge) noexcept
+{
+    for (auto quote = line.find('"'); quote != std::string_view::npos;
+         quote = line.find('"', quote + 1)) {
+        if (parse_edge(line.substr(quote), edge)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool is_end_line(std::string_view line) noexcept
+{
+    return trim(line) == "}";
+}
+
+// line without the terminating new line, like std::getline
+inline std::string_view next_line(std::string_view text, size_t& pos) noexcept
+{
+    const auto begin = text.data() + pos;
+    const auto rest = text.size() - pos;
+    const auto nl = static_cast<const char*>(std::memchr(begin, '\n', rest));
+    const auto length = nl ? static_cast<size_t>(nl - begin) : rest;
+    pos += nl ? length + 1 : length;
+    return std::string_view(begin, length);
+}
+
+[[noreturn]] inline void throw_line_error(size_t i, std::string_view line)
+{
+    throw std::runtime_error("dotfile error on line " + std::to_string(i)
+        + ':' + std::string(line));
+}
+
+[[noreturn]] inline void throw_format_error()
+{
+    throw std::runtime_error("error in simplified dot format");
+}
+
+// skips the leading empty lines and the digraph statement, returns the
+// position of the edge listing or npos if the text has no lines at all,
+// lines is increased by the number of lines consumed
+inline size_t find_edges_begin(std::string_view text, size_t& lines)
+{
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const auto line = next_line(text, pos);
+        ++lines;
+        if (is_empty_line(line))
+            continue;
+        if (is_start_line(line))
+            return pos;
+        throw_line_error(lines, line);
+    }
+    if (lines != 0) {
+        throw_format_error();
+    }
+    return std::string_view::npos;
+}
+
+// edge lines of a part of the edge listing, parsing stops at the closing
+// bracket or at the first invalid line
+template <typename EdgesT>
+struct basic_edges_chunk {
+    EdgesT edges;
+    // lines consumed, including the closing or the invalid line
+    size_t lines{};
+    bool closed{};
+    bool failed{};
+    std::string_view failed_line{};
+};
+
+using edges_chunk = basic_edges_chunk<std::vector<edge_view>>;
+
+// the edges are appended to edges, which may come with an allocator
+template <typename EdgesT = std::vector<edge_view>>
+basic_edges_chunk<EdgesT> parse_edge_lines(
+    std::string_view text, EdgesT edges = EdgesT())
+{
+    basic_edges_chunk<EdgesT> res{ std::move(edges) };
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const auto line = next_line(text, pos);
+        ++res.lines;
+        if (edge_view edge; parse_edge_line(line, edge)) {
+            res.edges.push_back(edge);
+        }
+        else if (is_end_line(line)) {
+            res.closed = true;
+            break;
+        }
+        else if (!is_empty_line(line)) {
+            res.failed = true;
+            res.failed_line = line;
+            break;
+        }
+    }
+    return res;
+}
+
+// parts of text of about chunk_size bytes, split after new lines
+inline std::vector<std::string_view> split_lines(
+    std::string_view text, size_t chunk_size)
+{
+    std::vector<std::string_view> res;
+    size_t begin = 0;
+    while (begin < text.size()) {
+        auto end = std::min(begin + chunk_size, text.size());
+        if (end < text.size()) {
+            const auto nl = text.find('\n', end - 1);
+            end = nl == std::string_view::npos ? text.size() : nl + 1;
+        }
+        res.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return res;
+}
+
+template <typename EdgesT>
+EdgesT parse_edges(std::string_view dot_text, EdgesT edges)
+{
+    size_t lines = 0;
+    const auto begin = find_edges_begin(dot_text, lines);
+    if (begin == std::string_view::npos) {
+        return edges;
+    }
+    auto chunk = parse_edge_lines(dot_text.substr(begin), std::move(edges));
+    if (chunk.failed) {
+        throw_line_error(lines + chunk.lines, chunk.failed_line);
+    }
+    if (!chunk.closed) {
+        throw_format_error();
+    }
+    return std::move(chunk.edges);
+}
+
+// copies the labels of the parsed edges into res
+template <typename EdgesT, typename ResultT>
+ResultT to_owning_edges(const EdgesT& edges, ResultT res)
+{
+    res.reserve(edges.size());
+    for (const auto & [ from, to ] : edges) {
+        res.emplace_back(from, to);
+    }
+    return res;
+}
+
+} // namespace detail
+
 /// \brief parsing simplified dot file with format
 /// \verbatim
 ///  digraph G{
@@ -18,61 +268,91 @@ namespace utils {
 /// simplifications on file format: digraph opening statment followed
 /// by edge listings one per line (use singele quote iside string literal
 /// , terminated by closing bracket on a new line
-inline auto parse_simplified_dot(std::istream& dot_text)
+///
+/// single pass over the text without copies, the returned labels point
+/// into dot_text, which has to outlive them
+inline std::vector<edge_view> parse_simplified_dot(std::string_view dot_text)
 {
+    return detail::parse_edges(dot_text, std::vector<edge_view>());
+}
 
-    static const std::regex digraph_start(R"#(\s*digraph\s+[^{]\s*\{\s*)#");
-    static const std::regex digraph_edge(
-        R"#(\s*"([^"]+)"\s*->\s*"([^"]+)"\s*;\s*)#");
-    static const std::regex digraph_end(R"#(\s*\}\s*)#");
-    static const std::regex digraph_empty(R"#(\s*)#");
-
-    enum class parse_state {
-        START,
-        EDGES,
-        END,
-    } state
-        = parse_state::START;
-
-    std::vector<std::pair<std::string, std::string>> res;
-    size_t i = 0;
-    std::string line;
-    while (dot_text && std::getline(dot_text, line)) {
-        ++i;
-        const auto throw_error = [i, &line]() {
-            throw std::runtime_error(
-                "dotfile error on line " + std::to_string(i) + ':' + line);
-        };
+/// \brief parses like parse_simplified_dot(std::string_view), the result
+/// is allocated from resource
+inline std::pmr::vector<edge_view> parse_simplified_dot(
+    std::string_view dot_text, std::pmr::memory_resource* resource)
+{
+    return detail::parse_edges(
+        dot_text, std::pmr::vector<edge_view>(resource));
+}
 
-        if (std::regex_match(line, digraph_empty))
-            continue;
-        switch (state) {
-        case parse_state::START: {
-            if (std::regex_match(line, digraph_start))
-                state = parse_state::EDGES;
-            else
-                throw_error();
-        } break;
-        case parse_state::EDGES: {
-            if (std::smatch match; std::regex_search(line, match, digraph_edge))
-                res.emplace_back(match[1], match[2]);
-            else if (std::regex_match(line, digraph_end))
-                state = parse_state::END;
-            else
-                throw_error();
-        } break;
-        case parse_state::END:
+/// \brief parses the edge listing in chunks of about chunk_size bytes on
+/// the threads of pool, results and errors are the same as the ones of
+/// the sequential parse_simplified_dot(std::string_view)
+inline std::vector<edge_view> parse_simplified_dot(
+    std::string_view dot_text, thread_pool& pool, size_t chunk_size = 1 << 20)
+{
+    size_t lines = 0;
+    const auto begin = detail::find_edges_begin(dot_text, lines);
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    const auto edges_text = dot_text.substr(begin);
+    chunk_size = std::max(chunk_size, edges_text.size() / (4 * pool.size()));
+    std::vector<std::future<detail::edges_chunk>> futures;
+    for (auto part : detail::split_lines(edges_text, chunk_size)) {
+        futures.push_back(
+            pool.submit([part] { return detail::parse_edge_lines(part); }));
+    }
+    std::vector<detail::edges_chunk> chunks;
+    chunks.reserve(futures.size());
+    for (auto& f : futures) {
+        chunks.push_back(f.get());
+    }
+    // chunks after the closing bracket are ignored, just like the lines
+    // after it in the sequential parser
+    size_t num_edges = 0;
+    auto last = chunks.begin();
+    for (; last != chunks.end(); ++last) {
+        num_edges += last->edges.size();
+        if (last->failed) {
+            detail::throw_line_error(lines + last->lines, last->failed_line);
+        }
+        if (last->closed) {
             break;
-        default:
-            throw std::logic_error(
-                "error in simplified dot parser state machine");
-        };
+        }
+        lines += last->lines;
     }
-    if (i != 0 && state != parse_state::END) {
-        throw std::runtime_error("error in simplified dot format");
+    if (last == chunks.end()) {
+        detail::throw_format_error();
+    }
+    std::vector<edge_view> res;
+    res.reserve(num_edges);
+    for (auto it = chunks.begin(); it != std::next(last); ++it) {
+        res.insert(res.end(), it->edges.begin(), it->edges.end());
     }
     return res;
-} // namespace utils
+}
+
+/// \brief parses the whole stream, see parse_simplified_dot(std::string_view)
+inline auto parse_simplified_dot(std::istream& dot_text)
+{
+    const std::string text(std::istreambuf_iterator<char>(dot_text), {});
+    return detail::to_owning_edges(parse_simplified_dot(std::string_view(text)),
+        std::vector<std::pair<std::string, std::string>>());
+}
+
+/// \brief parses the whole stream like parse_simplified_dot(std::istream&),
+/// the text, the result and its labels are allocated from resource
+inline auto parse_simplified_dot(
+    std::istream& dot_text, std::pmr::memory_resource* resource)
+{
+    const std::pmr::string text(
+        std::istreambuf_iterator<char>(dot_text), {}, resource);
+    return detail::to_owning_edges(
+        parse_simplified_dot(std::string_view(text), resource),
+        std::pmr::vector<std::pair<std::pmr::string, std::pmr::string>>(
+            resource));
+}
 
 } // namespace utils
 } // namespace job_sheduler
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <vertex_index.h>
+
+namespace job_sheduler {
+
+/// \brief contiguous run of vertices of a static_schedule
+template <typename VertexT>
+class static_level {
+public:
+    using iterator = const VertexT*;
+
+    constexpr static_level(iterator first, iterator last) noexcept
+        : m_first(first)
+        , m_last(last)
+    {
+    }
+
+    constexpr iterator begin() const noexcept { return m_first; }
+    constexpr iterator end() const noexcept { return m_last; }
+    constexpr size_t size() const noexcept
+    {
+        return static_cast<size_t>(m_last - m_first);
+    }
+    constexpr bool empty() const noexcept { return m_first == m_last; }
+    constexpr const VertexT& operator[](size_t i) const noexcept
+    {
+        return m_first[i];
+    }
+
+private:
+    iterator m_first;
+    iterator m_last;
+};
+
+/// \brief level schedule of a static_graph, the vertices of every level in
+/// the order graph::get_full_schedule returns them
+template <typename VertexT, size_t MaxVertices>
+class static_schedule {
+public:
+    using vertex_type = VertexT;
+    using level_type = static_level<VertexT>;
+
+    constexpr size_t num_levels() const noexcept { return m_num_levels; }
+
+    constexpr size_t num_vertices() const noexcept
+    {
+        return m_offsets[m_num_levels];
+    }
+
+    /// \brief level i of the schedule, precondition: i < num_levels()
+    constexpr level_type operator[](size_t i) const noexcept
+    {
+        return level_type(m_vertices.data() + m_offsets[i],
+            m_vertices.data() + m_offsets[i + 1]);
+    }
+
+    /// \brief the schedule in the format of graph::get_full_schedule
+    std::vector<std::vector<vertex_type>> get_full_schedule() const
+    {
+        std::vector<std::vector<vertex_type>> res;
+        res.reserve(m_num_levels);
+        for (size_t i = 0; i < m_num_levels; ++i) {
+            const auto level = (*this)[i];
+            res.emplace_back(level.begin(), level.end());
+        }
+        return res;
+    }
+
+private:
+    template <typename, size_t, size_t>
+    friend class static_graph;
+
+    // vertices level by level, level i is [m_offsets[i], m_offsets[i + 1])
+    std::array<VertexT, MaxVertices> m_vertices{};
+    std::array<size_t, MaxVertices + 1> m_offsets{};
+    size_t m_num_levels{};
+};
+
+/// \brief job graph of fixed capacity that can be built and scheduled at
+/// compile time
+///
+/// meant for dependency graphs that are known at compile time, e.g.
+/// \code
+///  constexpr auto schedule = make_static_graph({
+///      std::make_pair("a"sv, "b"sv), std::make_pair("b"sv, "c"sv) })
+///      .schedule();
+/// \endcode
+/// vertices are interned in order of their first appearance like in graph,
+/// so the levels list them in the same order. VertexT has to be a literal
+/// type comparable with ==, e.g. an integral or std::string_view. Lookups
+/// are linear, building the graph is O(V * E), which is fine for the size
+/// of graphs written in code.
+///
+/// errors are thrown as std::runtime_error, in a constant expression that
+/// makes a cycle or a graph exceeding its capacity a compile error.
+template <typename VertexT, size_t MaxVertices, size_t MaxEdges>
+class static_graph {
+public:
+    using vertex_type = VertexT;
+    using edge_type = std::pair<VertexT, VertexT>;
+    using schedule_type = static_schedule<VertexT, MaxVertices>;
+
+    static_assert(!std::is_pointer_v<VertexT>,
+        "pointers are compared by address, use std::string_view for labels");
+
+    template <size_t NumEdges>
+    constexpr explicit static_graph(const edge_type (&edges)[NumEdges]);
+
+    constexpr size_t num_vertices() const noexcept { return m_num_vertices; }
+
+    constexpr size_t num_edges() const noexcept { return m_num_edges; }
+
+    /// \brief vertex of the given id, precondition: id < num_vertices()
+    constexpr const vertex_type& vertex_at(vertex_id id) const noexcept
+    {
+        return m_vertices[id];
+    }
+
+    constexpr std::optional<vertex_id> id_of(const vertex_type& v) const
+    {
+        for (vertex_id id = 0; id < m_num_vertices; ++id) {
+            if (m_vertices[id] == v) {
+                return id;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// \brief number of the edges ending in id
+    constexpr size_t in_degree(vertex_id id) const noexcept
+    {
+        return m_in_degree[id];
+    }
+
+    /// \brief successors of id in the order of the edges
+    constexpr static_level<vertex_id> out_edges(vertex_id id) const noexcept
+    {
+        return static_level<vertex_id>(m_targets.data() + m_offsets[id],
+            m_targets.data() + m_offsets[id + 1]);
+    }
+
+    /// \brief all levels of the graph, throws if the graph has a cycle
+    constexpr schedule_type schedule() const;
+
+private:
+    constexpr vertex_id intern(const vertex_type& v);
+
+    std::array<VertexT, MaxVertices> m_vertices{};
+    // successors in csr form, the ones of id are
+    // [m_offsets[id], m_offsets[id + 1])
+    std::array<size_t, MaxVertices + 1> m_offsets{};
+    std::array<vertex_id, MaxEdges> m_targets{};
+    std::array<size_t, MaxVertices> m_in_degree{};
+    size_t m_num_vertices{};
+    size_t m_num_edges{};
+};
+
+template <typename VertexT, size_t MaxVertices, size_t MaxEdges>
+template <size_t NumEdges>
+constexpr static_graph<VertexT, MaxVertices, MaxEdges>::static_graph(
+    const edge_type (&edges)[NumEdges])
+    : m_num_edges(NumEdges)
+{
+    static_assert(NumEdges <= MaxEdges, "too many edges for static_graph");
+    std::array<vertex_id, MaxEdges> from{};
+    for (size_t i = 0; i < NumEdges; ++i) {
+        from[i] = intern(edges[i].first);
+        m_targets[i] = intern(edges[i].second);
+    }
+    // counting sort of the edges by source, stable to keep their order
+    std::array<vertex_id, MaxEdges> to = m_targets;
+    for (size_t i = 0; i < NumEdges; ++i) {
+        ++m_offsets[from[i] + 1];
+        ++m_in_degree[to[i]];
+    }
+    for (size_t id = 0; id < m_num_vertices; ++id) {
+        m_offsets[id + 1] += m_offsets[id];
+    }
+    std::array<size_t, MaxVertices + 1> next = m_offsets;
+    for (size_t i = 0; i < NumEdges; ++i) {
+        m_targets[next[from[i]]++] = to[i];
+    }
+}
+
+template <typename VertexT, size_t MaxVertices, size_t MaxEdges>
+constexpr vertex_id static_graph<VertexT, MaxVertices, MaxEdges>::intern(
+    const vertex_type& v)
+{
+    if (const auto id = id_of(v)) {
+        return *id;
+    }
+    if (m_num_vertices == MaxVertices) {
+        throw std::runtime_error("too many vertices for static_graph");
+    }
+    m_vertices[m_num_vertices] = v;
+    return static_cast<vertex_id>(m_num_vertices++);
+}
+
+template <typename VertexT, size_t MaxVertices, size_t MaxEdges>
+constexpr auto static_graph<VertexT, MaxVertices, MaxEdges>::schedule() const
+    -> schedule_type
+{
+    schedule_type res;
+    std::array<size_t, MaxVertices> pending = m_in_degree;
+    std::array<vertex_id, MaxVertices> order{};
+    size_t num_ordered = 0;
+    for (vertex_id id = 0; id < m_num_vertices; ++id) {
+        if (pending[id] == 0) {
+            order[num_ordered++] = id;
+        }
+    }
+    // the ready vertices of a level are released in order, like in
+    // graph::next_level
+    size_t begin = 0;
+    while (begin != num_ordered) {
+        const auto end = num_ordered;
+        for (auto i = begin; i < end; ++i) {
+            res.m_vertices[i] = m_vertices[order[i]];
+            for (auto s : out_edges(order[i])) {
+                if (--pending[s] == 0) {
+                    order[num_ordered++] = s;
+                }
+            }
+        }
+        res.m_offsets[++res.m_num_levels] = end;
+        begin = end;
+    }
+    if (num_ordered != m_num_vertices) {
+        throw std::runtime_error("cycle in job graph");
+    }
+    return res;
+}
+
+/// \brief static_graph with room for the given edges
+template <typename VertexT, size_t NumEdges>
+constexpr auto make_static_graph(
+    const std::pair<VertexT, VertexT> (&edges)[NumEdges])
+{
+    return static_graph<VertexT, 2 * NumEdges, NumEdges>(edges);
+}
+
+} // namespace job_sheduler
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace job_sheduler {
+
+/// \brief fixed size work stealing pool of worker threads
+///
+/// every worker has its own task queue, tasks posted from a worker go to
+/// the back of its own queue and are taken from there LIFO, idle workers
+/// steal from the front of the other queues. Tasks posted from other
+/// threads are distributed round robin. The destructor finishes all tasks,
+/// including the ones posted by tasks.
+class thread_pool {
+public:
+    /// \brief num_threads == 0 means one thread per hardware thread
+    explicit thread_pool(size_t num_threads = 0);
+
+    thread_pool(const thread_pool&) = delete;
+
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool();
+
+    size_t size() const noexcept { return m_queues.size(); }
+
+    /// \brief schedules f for execution, exceptions thrown by f are
+    /// propagated through the returned future
+    template <typename F>
+    auto submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+    /// \brief schedules f for execution without a future, f must not throw
+    void post(std::function<void()> f);
+
+private:
+    using task_t = std::function<void()>;
+
+    struct worker_queue {
+        std::mutex mutex;
+        std::deque<task_t> tasks;
+    };
+
+    // index of the calling thread in this pool, size() for other threads
+    size_t current_worker() const noexcept;
+
+    std::optional<task_t> pop(size_t worker);
+    void run(size_t worker);
+
+    std::vector<std::unique_ptr<worker_queue>> m_queues;
+    std::atomic<size_t> m_next_queue{ 0 };
+    // tasks in the queues, increased under m_mutex to avoid lost wake ups
+    std::atomic<size_t> m_queued{ 0 };
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop{};
+    std::vector<std::thread> m_threads;
+};
+
+namespace detail {
+
+struct worker_identity {
+    const thread_pool* pool{};
+    size_t index{};
+};
+
+inline worker_identity& this_worker() noexcept
+{
+    static thread_local worker_identity identity;
+    return identity;
+}
+
+} // namespace detail
+
+inline thread_pool::thread_pool(size_t num_threads)
+{
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_queues.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        m_queues.push_back(std::make_unique<worker_queue>());
+    }
+    m_threads.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        m_threads.emplace_back([this, i] { run(i); });
+    }
+}
+
+inline thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto& t : m_threads) {
+        t.join();
+    }
+}
+
+template <typename F>
+inline auto thread_pool::submit(F&& f)
+    -> std::future<std::invoke_result_t<std::decay_t<F>>>
+{
+    using result_type = std::invoke_result_t<std::decay_t<F>>;
+    // std::function needs a copyable target
+    auto task = std::make_shared<std::packaged_task<result_type()>>(
+        std::forward<F>(f));
+    auto res = task->get_future();
+    post([task] { (*task)(); });
+    return res;
+}
+
+inline void thread_pool::post(std::function<void()> f)
+{
+    auto worker = current_worker();
+    if (worker == size()) {
+        worker = m_next_queue.fetch_add(1, std::memory_order_relaxed) % size();
+    }
+    {
+        auto& queue = *m_queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(f));
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_queued;
+    }
+    m_cv.notify_one();
+}
+
+inline size_t thread_pool::current_worker() const noexcept
+{
+    const auto& identity = detail::this_worker();
+    return identity.pool == this ? identity.index : size();
+}
+
+inline auto thread_pool::pop(size_t worker) -> std::optional<task_t>
+{
+    std::optional<task_t> res;
+    {
+        auto& own = *m_queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            res = std::move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+    for (size_t i = 1; !res && i < size(); ++i) {
+        auto& victim = *m_queues[(worker + i) % size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            res = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+    if (res) {
+        --m_queued;
+    }
+    return res;
+}
+
+inline void thread_pool::run(size_t worker)
+{
+    detail::this_worker() = { this, worker };
+    for (;;) {
+        if (auto task = pop(worker)) {
+            (*task)();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_stop || m_queued != 0; });
+        if (m_stop && m_queued == 0) {
+            return;
+        }
+    }
+}
+
+} // namespace job_sheduler
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <graph_storage.h>
+
+namespace job_sheduler {
+
+/// \brief id that never refers to a vertex
+constexpr vertex_id invalid_vertex = std::numeric_limits<vertex_id>::max();
+
+/// \brief vertex state during scheduling
+enum class vertex_state {
+    pending, ///< has predecessors that are not scheduled yet
+    ready, ///< all predecessors are scheduled, part of the next schedule
+    scheduled, ///< returned by a schedule already
+    removed, ///< removed from the graph, its id is not reused
+};
+
+/// \brief true if KeyT can be looked up among VertexT vertices by its
+/// std::string_view representation
+template <typename VertexT, typename KeyT>
+constexpr bool is_transparent_key_v
+    = std::is_convertible_v<const VertexT&, std::string_view>
+    && std::is_convertible_v<const KeyT&, std::string_view>;
+
+/// \brief hashing and comparison of lookup keys with vertices
+///
+/// string like vertices are hashed as std::string_view (which gives the same
+/// hash as std::hash<std::string>), so they can be looked up by any string
+/// like key without materializing a VertexT, other keys are converted to
+/// VertexT for hashing
+template <typename VertexT>
+struct vertex_key {
+    template <typename KeyT>
+    static size_t hash(const KeyT& key)
+    {
+        if constexpr (is_transparent_key_v<VertexT, KeyT>) {
+            return std::hash<std::string_view>{}(key);
+        }
+        else {
+            return std::hash<VertexT>{}(key);
+        }
+    }
+
+    template <typename KeyT>
+    static bool equal(const VertexT& v, const KeyT& key)
+    {
+        if constexpr (is_transparent_key_v<VertexT, KeyT>) {
+            return std::string_view(v) == std::string_view(key);
+        }
+        else {
+            return v == key;
+        }
+    }
+};
+
+/// \brief open addressing hash table of dense vertex ids
+///
+/// the table does not own the keys, these are the vertex payloads stored
+/// elsewhere (e.g. in a graph storage) and compared through the equality
+/// callback given to find and insert, the table only stores the slots and
+/// the hash of every id, so it costs a few bytes per vertex
+class id_hash_table {
+public:
+    id_hash_table() = default;
+
+    explicit id_hash_table(size_t expected) { reserve(expected); }
+
+    void reserve(size_t expected);
+
+    /// \brief number of ids handed out, ids are 0..size()-1, erased ids
+    /// are not reused
+    size_t size() const noexcept { return m_hashes.size(); }
+
+    /// \brief bytes allocated for the slots and the hashes
+    size_t memory_usage() const noexcept
+    {
+        return m_slots.capacity() * sizeof(vertex_id)
+            + m_hashes.capacity() * sizeof(size_t);
+    }
+
+    /// \brief returns id for which equal(id) holds or invalid_vertex
+    template <typename EqualF>
+    vertex_id find(size_t hash, EqualF&& equal) const;
+
+    /// \brief looks up the key like find, if not present it is added with
+    /// the next id (i.e. size()), returns the id and whether it was added
+    template <typename EqualF>
+    std::pair<vertex_id, bool> insert(size_t hash, EqualF&& equal);
+
+    /// \brief removes the id for which equal(id) holds, returns false if
+    /// there is none
+    template <typename EqualF>
+    bool erase(size_t hash, EqualF&& equal);
+
+private:
+    static size_t mix(size_t hash) noexcept;
+    size_t mask() const noexcept { return m_slots.size() - 1; }
+    void rehash(size_t num_slots);
+
+    std::vector<vertex_id> m_slots;
+    std::vector<size_t> m_hashes;
+};
+
+inline void id_hash_table::reserve(size_t expected)
+{
+    // keep the load factor at most 1/2
+    size_t num_slots = 16;
+    while (num_slots < 2 * expected) {
+        num_slots *= 2;
+    }
+    if (num_slots > m_slots.size()) {
+        rehash(num_slots);
+    }
+    m_hashes.reserve(expected);
+}
+
+template <typename EqualF>
+inline vertex_id id_hash_table::find(size_t hash, EqualF&& equal) const
+{
+    if (m_slots.empty()) {
+        return invalid_vertex;
+    }
+    for (auto i = mix(hash) & mask();; i = (i + 1) & mask()) {
+        const auto id = m_slots[i];
+        if (id == invalid_vertex) {
+            return invalid_vertex;
+        }
+        if (m_hashes[id] == hash && equal(id)) {
+            return id;
+        }
+    }
+}
+
+template <typename EqualF>
+inline std::pair<vertex_id, bool> id_hash_table::insert(
+    size_t hash, EqualF&& equal)
+{
+    if (2 * (size() + 1) > m_slots.size()) {
+        rehash(m_slots.empty() ? 16 : 2 * m_slots.size());
+    }
+    auto i = mix(hash) & mask();
+    for (; m_slots[i] != invalid_vertex; i = (i + 1) & mask()) {
+        const auto id = m_slots[i];
+        if (m_hashes[id] == hash && equal(id)) {
+            return { id, false };
+        }
+    }
+    detail::check_vertex_count(size() + 1);
+    const auto id = static_cast<vertex_id>(size());
+    m_slots[i] = id;
+    m_hashes.push_back(hash);
+    return { id, true };
+}
+
+template <typename EqualF>
+inline bool id_hash_table::erase(size_t hash, EqualF&& equal)
+{
+    if (m_slots.empty()) {
+        return false;
+    }
+    auto i = mix(hash) & mask();
+    for (;; i = (i + 1) & mask()) {
+        const auto id = m_slots[i];
+        if (id == invalid_vertex) {
+            return false;
+        }
+        if (m_hashes[id] == hash && equal(id)) {
+            break;
+        }
+    }
+    // backward shift deletion: the following ids of the cluster that would
+    // not be found across the hole are moved into it
+    for (auto j = (i + 1) & mask(); m_slots[j] != invalid_vertex;
+         j = (j + 1) & mask()) {
+        const auto home = mix(m_hashes[m_slots[j]]) & mask();
+        if (((j - home) & mask()) >= ((j - i) & mask())) {
+            m_slots[i] = m_slots[j];
+            i = j;
+        }
+    }
+    m_slots[i] = invalid_vertex;
+    return true;
+}
+
+inline size_t id_hash_table::mix(size_t hash) noexcept
+{
+    // std::hash of integers is the identity, spread it over all the bits
+    std::uint64_t h = hash;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+}
+
+inline void id_hash_table::rehash(size_t num_slots)
+{
+    // erased ids are not in the slots anymore
+    std::vector<vertex_id> slots(num_slots, invalid_vertex);
+    slots.swap(m_slots);
+    for (auto id : slots) {
+        if (id == invalid_vertex) {
+            continue;
+        }
+        auto i = mix(m_hashes[id]) & mask();
+        while (m_slots[i] != invalid_vertex) {
+            i = (i + 1) & mask();
+        }
+        m_slots[i] = id;
+    }
+}
+
+} // namespace job_sheduler
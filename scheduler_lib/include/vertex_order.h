@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <memory_resource>
+#include <vector>
+
+#include <graph_storage.h>
+#include <vertex_index.h>
+
+namespace job_sheduler {
+
+/// \brief ids of the vertices of the graph level by level, within a level
+/// in the order graph::next_level schedules them
+///
+/// only the structure of the graph is used, its scheduling state is
+/// ignored. Removed vertices are left out, vertices on or behind a cycle
+/// follow the levels in the order of their ids.
+template <typename GraphT>
+std::vector<vertex_id> level_order(const GraphT& graph)
+{
+    const auto& storage = graph.storage();
+    const auto n = storage.size();
+    std::vector<size_t> pending(n);
+    std::vector<vertex_id> res;
+    res.reserve(n);
+    for (vertex_id id = 0; id < n; ++id) {
+        if (graph.state(id) == vertex_state::removed) {
+            continue;
+        }
+        pending[id] = storage.in_edges(id).size();
+        if (pending[id] == 0) {
+            res.push_back(id);
+        }
+    }
+    // the vertices released by a level are appended behind it, so res is
+    // the concatenation of the levels
+    for (size_t i = 0; i < res.size(); ++i) {
+        for (auto s : storage.out_edges(res[i])) {
+            if (--pending[s] == 0) {
+                res.push_back(s);
+            }
+        }
+    }
+    // vertices never released are on or behind a cycle
+    for (vertex_id id = 0; id < n; ++id) {
+        if (pending[id] != 0) {
+            res.push_back(id);
+        }
+    }
+    return res;
+}
+
+/// \brief copy of the graph with the vertices of order renumbered to
+/// 0, 1, ..., vertices not in order are dropped with their edges
+///
+/// payloads and adjacency are laid out in the new order and the edges of
+/// every vertex are sorted by the new ids. The copy is not scheduled and
+/// uses the memory resource of the graph.
+template <typename GraphT>
+GraphT reorder_vertices(
+    const GraphT& graph, const std::vector<vertex_id>& order)
+{
+    using storage_type = typename GraphT::storage_type;
+    using vertex_type = typename GraphT::vertex_type;
+    const auto& storage = graph.storage();
+    auto* resource = storage.resource();
+    std::vector<vertex_id> new_id(storage.size(), invalid_vertex);
+    std::pmr::vector<vertex_type> vertices(resource);
+    vertices.reserve(order.size());
+    for (auto id : order) {
+        new_id[id] = static_cast<vertex_id>(vertices.size());
+        vertices.push_back(graph.vertex_at(id));
+    }
+    edge_list edges;
+    edges.reserve(graph.num_edges());
+    for (auto id : order) {
+        const auto first = edges.size();
+        for (auto s : storage.out_edges(id)) {
+            if (new_id[s] != invalid_vertex) {
+                edges.emplace_back(new_id[id], new_id[s]);
+            }
+        }
+        std::sort(edges.begin() + first, edges.end());
+    }
+    return GraphT(storage_type(std::move(vertices), edges, resource));
+}
+
+/// \brief copy of the graph with the vertices numbered in level_order
+///
+/// the vertices of a level are contiguous in the storage and the
+/// successors of a level are close to each other, walking the graph while
+/// scheduling it touches far less memory than with ids in order of first
+/// appearance in the input. The copy of a graph that was not modified has
+/// the same schedule, also the order within the levels is the same.
+template <typename GraphT>
+GraphT reorder_by_level(const GraphT& graph)
+{
+    return reorder_vertices(graph, level_order(graph));
+}
+
+} // namespace job_sheduler
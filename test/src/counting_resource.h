@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace test_utils {
+
+/// \brief memory resource counting the allocations passed to the
+/// upstream resource
+class counting_resource : public std::pmr::memory_resource {
+public:
+    explicit counting_resource(std::pmr::memory_resource* upstream
+        = std::pmr::new_delete_resource())
+        : m_upstream(upstream)
+    {
+    }
+
+    size_t allocations() const noexcept { return m_allocations; }
+    size_t deallocations() const noexcept { return m_deallocations; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        ++m_allocations;
+        return m_upstream->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        ++m_deallocations;
+        m_upstream->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const
+        noexcept override
+    {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* m_upstream;
+    size_t m_allocations{};
+    size_t m_deallocations{};
+};
+
+} // namespace test_utils
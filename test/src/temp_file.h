@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+#include <unistd.h>
+
+namespace test_utils {
+
+/// \brief uniquely named file with the given content, removed on
+/// destruction
+struct temp_file {
+    explicit temp_file(const std::string& content = {})
+    {
+        char name[] = "/tmp/job_scheduler_test_XXXXXX";
+        const int fd = ::mkstemp(name);
+        if (fd < 0) {
+            std::abort();
+        }
+        path = name;
+        auto written = ::write(fd, content.data(), content.size());
+        ::close(fd);
+        if (written != static_cast<ssize_t>(content.size())) {
+            std::abort();
+        }
+    }
+    temp_file(const temp_file&) = delete;
+    temp_file& operator=(const temp_file&) = delete;
+    ~temp_file() { std::remove(path.c_str()); }
+    std::string path;
+};
+
+/// \brief uniquely named empty directory, removed with its content on
+/// destruction
+struct temp_dir {
+    temp_dir()
+    {
+        char name[] = "/tmp/job_scheduler_test_XXXXXX";
+        if (!::mkdtemp(name)) {
+            std::abort();
+        }
+        path = name;
+    }
+    temp_dir(const temp_dir&) = delete;
+    temp_dir& operator=(const temp_dir&) = delete;
+    ~temp_dir() { std::filesystem::remove_all(path); }
+    std::string path;
+};
+
+} // namespace test_utils
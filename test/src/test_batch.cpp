@@ -0,0 +1,89 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <batch.h>
+#include <thread_pool.h>
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+TEST_CASE("batch processes every item", "[batch]")
+{
+    thread_pool pool(4);
+    std::vector<std::atomic<int>> processed(1000);
+    const auto res = run_batch(
+        processed.size(), [&](size_t i) { ++processed[i]; }, pool);
+    REQUIRE(res.all_succeeded());
+    REQUIRE(res.errors.size() == processed.size());
+    for (const auto& p : processed) {
+        REQUIRE(p == 1);
+    }
+}
+
+TEST_CASE("batch respects the concurrency limit", "[batch]")
+{
+    thread_pool pool(8);
+    std::atomic<size_t> in_flight{ 0 };
+    std::atomic<size_t> max_in_flight{ 0 };
+    const auto res = run_batch(64,
+        [&](size_t) {
+            const auto now = ++in_flight;
+            auto max = max_in_flight.load();
+            while (
+                now > max && !max_in_flight.compare_exchange_weak(max, now)) {
+            }
+            std::this_thread::sleep_for(1ms);
+            --in_flight;
+        },
+        pool, 3);
+    REQUIRE(res.all_succeeded());
+    REQUIRE(max_in_flight >= 1);
+    REQUIRE(max_in_flight <= 3);
+}
+
+TEST_CASE("failing items don't stop the batch", "[batch]")
+{
+    thread_pool pool(2);
+    std::atomic<size_t> processed{ 0 };
+    const auto res = run_batch(10,
+        [&](size_t i) {
+            ++processed;
+            if (i % 3 == 0) {
+                throw std::runtime_error("bad input");
+            }
+        },
+        pool);
+    REQUIRE(processed == 10);
+    REQUIRE(res.num_failed() == 4);
+    REQUIRE(res.errors[3]);
+    REQUIRE(!res.errors[4]);
+    REQUIRE_THROWS_AS(std::rethrow_exception(res.errors[9]),
+        std::runtime_error);
+}
+
+TEST_CASE("empty batch", "[batch]")
+{
+    thread_pool pool(2);
+    const auto res = run_batch(0, [](size_t) {}, pool);
+    REQUIRE(res.errors.empty());
+    REQUIRE(res.all_succeeded());
+}
+
+TEST_CASE("manifest lists the inputs", "[batch]")
+{
+    const auto manifest = "# graphs\n"
+                          "a.txt\n"
+                          "\n"
+                          "  dir/b.txt \r\n"
+                          "#c.txt\n"
+                          "d.txt"sv;
+    REQUIRE(utils::parse_manifest(manifest)
+        == std::vector<std::string_view>{ "a.txt", "dir/b.txt", "d.txt" });
+}
@@ -0,0 +1,122 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <binary_graph.h>
+#include <input_buffer.h>
+#include <job_graph.h>
+
+#include "temp_file.h"
+#include "test_graphs.h"
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+using test_utils::create_reference_graph;
+
+namespace {
+
+std::string to_binary()
+{
+    auto graph = create_reference_graph();
+    std::ostringstream oss;
+    write_binary_graph(oss, graph);
+    return oss.str();
+}
+
+binary_graph load_from_string(const std::string& content)
+{
+    std::istringstream iss(content);
+    return binary_graph::load(utils::input_buffer::read_stream(iss));
+}
+
+template <typename GraphT>
+auto sorted_schedule(GraphT& graph)
+{
+    std::vector<std::vector<std::string>> res;
+    for (auto& level : graph.get_full_schedule()) {
+        res.emplace_back(level.begin(), level.end());
+        std::sort(res.back().begin(), res.back().end());
+    }
+    return res;
+}
+
+} // namespace
+
+TEST_CASE("binary graph round trip through a mapped file", "[binary graph]")
+{
+    test_utils::temp_file file(to_binary());
+    auto loaded = binary_graph::load(file.path);
+    auto& graph = loaded.get();
+    auto reference = create_reference_graph();
+    REQUIRE(graph.num_vertices() == reference.num_vertices());
+    REQUIRE(graph.num_edges() == reference.num_edges());
+    for (vertex_id id = 0; id < reference.storage().size(); ++id) {
+        REQUIRE(graph.vertex_at(id) == reference.vertex_at(id));
+    }
+    REQUIRE(graph.id_of("h"sv) == reference.id_of("h"sv));
+    REQUIRE(sorted_schedule(graph) == sorted_schedule(reference));
+}
+
+TEST_CASE("binary graph survives a move", "[binary graph]")
+{
+    auto loaded = load_from_string(to_binary());
+    auto moved = std::move(loaded);
+    REQUIRE(moved.get().find("j"sv) != moved.get().end());
+    REQUIRE(moved.get().next_schedule().size() == 2);
+}
+
+TEST_CASE("binary graph of a binary graph is the same", "[binary graph]")
+{
+    const auto content = to_binary();
+    auto loaded = load_from_string(content);
+    std::ostringstream oss;
+    write_binary_graph(oss, loaded.get());
+    REQUIRE(oss.str() == content);
+}
+
+TEST_CASE("binary graph without jobs", "[binary graph]")
+{
+    const std::vector<std::pair<std::string, std::string>> edges;
+    auto empty = make_graph(edges.cbegin(), edges.cend());
+    std::ostringstream oss;
+    write_binary_graph(oss, empty);
+    auto loaded = load_from_string(oss.str());
+    REQUIRE(loaded.get().num_vertices() == 0);
+    REQUIRE(loaded.get().num_edges() == 0);
+    REQUIRE(loaded.get().is_done());
+}
+
+TEST_CASE("invalid binary graphs are rejected", "[binary graph]")
+{
+    auto content = to_binary();
+    SECTION("empty") { REQUIRE_THROWS(load_from_string("")); }
+    SECTION("magic")
+    {
+        content[0] = 'X';
+        REQUIRE_THROWS_WITH(load_from_string(content), "not a binary graph");
+    }
+    SECTION("version")
+    {
+        content[8] = 2;
+        REQUIRE_THROWS_WITH(
+            load_from_string(content), "unsupported binary graph version 2");
+    }
+    SECTION("truncated")
+    {
+        content.resize(content.size() - 8);
+        REQUIRE_THROWS_WITH(
+            load_from_string(content), "truncated binary graph");
+    }
+    SECTION("vertex id out of range")
+    {
+        // last in edge source
+        content[content.size() - 8] = 100;
+        REQUIRE_THROWS(load_from_string(content));
+    }
+}
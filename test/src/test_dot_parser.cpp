@@ -1,11 +1,16 @@
 #include <catch.hpp>
 
 #include <simplified_dot_parser.h>
+#include <thread_pool.h>
+
+#include "counting_resource.h"
 
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 
-using namespace std::string_literals;
+using namespace std::literals;
 using namespace job_sheduler::utils;
 
 TEST_CASE("dot parser on a invalid graphs", "[dot parser]")
@@ -125,3 +130,163 @@ digraph G {
     REQUIRE((from_9 == "e" && to_9 == "f"));
     REQUIRE((from_10 == "j" && to_10 == "f"));
 }
+
+TEST_CASE("dot parser on a buffer returns views into the buffer",
+    "[dot parser]")
+{
+    const std::string simple_dot = "digraph G {\n  \"a\" -> \"bb\";\r\n}\n";
+    const std::string_view text(simple_dot);
+    auto res = parse_simplified_dot(text);
+    REQUIRE(res.size() == 1);
+    REQUIRE(res[0].first == "a");
+    REQUIRE(res[0].second == "bb");
+    REQUIRE(res[0].first.data() >= text.data());
+    REQUIRE(res[0].second.data() + 2 <= text.data() + text.size());
+}
+
+TEST_CASE("dot parser accepts every input of the regex based parser",
+    "[dot parser]")
+{
+    const auto text = "\t digraph G{ \n\"a\"->\"b\";\n \"b\" \t->  \"c\" ; "
+                      "// trailing\n\t}\ngarbage after the end\n"sv;
+    auto res = parse_simplified_dot(text);
+    REQUIRE(res.size() == 2);
+    REQUIRE((res[0] == edge_view{ "a", "b" }));
+    REQUIRE((res[1] == edge_view{ "b", "c" }));
+}
+
+TEST_CASE("dot parser finds edges anywhere in a line", "[dot parser]")
+{
+    const auto edge_of = [](std::string_view line) {
+        const auto text = "digraph G {\n"s + std::string(line) + "\n}\n";
+        const auto res = parse_simplified_dot(std::string_view(text));
+        REQUIRE(res.size() == 1);
+        return std::make_pair(
+            std::string(res[0].first), std::string(res[0].second));
+    };
+    REQUIRE((edge_of("  x \"a\" -> \"b\";") == std::make_pair("a"s, "b"s)));
+    REQUIRE((edge_of("\"x\" \"a\" -> \"b\";") == std::make_pair("a"s, "b"s)));
+    REQUIRE((edge_of("\"a\" \"b\" -> \"c\"; \"d\" -> \"e\";")
+        == std::make_pair("b"s, "c"s)));
+    REQUIRE((edge_of("\"a\" -> \"b\";;x") == std::make_pair("a"s, "b"s)));
+    // the first complete edge of the line
+    REQUIRE((edge_of("\"a\" -> \"b\" -> \"c\";")
+        == std::make_pair("b"s, "c"s)));
+
+    for (const auto line : { "x -> \"b\";"sv, "\"a\" -> \"b\" x;"sv,
+             "\"a\" - > \"b\";"sv, "\"a\" <- \"b\";"sv, "\"a\" -> \"\";"sv,
+             "\"a\" -> b;"sv, "\"a\";"sv }) {
+        const auto text = "digraph G {\n"s + std::string(line) + "\n}\n";
+        REQUIRE_THROWS_WITH(parse_simplified_dot(std::string_view(text)),
+            "dotfile error on line 2:" + std::string(line));
+    }
+}
+
+TEST_CASE("dot parser accepts graph names of any length", "[dot parser]")
+{
+    // the regex based parser only accepted names of one character
+    for (const auto start : { "digraph G {"sv, "digraph G{"sv,
+             "digraph graph_1 {"sv, "digraph \t name\t{ "sv,
+             "digraph  {"sv, "digraph {"sv }) {
+        const auto text = std::string(start) + "\n\"a\" -> \"b\";\n}\n";
+        REQUIRE(parse_simplified_dot(std::string_view(text)).size() == 1);
+    }
+    for (const auto start : { "digraph{"sv, "digraphG {"sv,
+             "digraph G"sv, "digraph G { x"sv, "digraph G {{"sv,
+             "graph G {"sv }) {
+        const auto text = std::string(start) + "\n\"a\" -> \"b\";\n}\n";
+        REQUIRE_THROWS_WITH(parse_simplified_dot(std::string_view(text)),
+            "dotfile error on line 1:" + std::string(start));
+    }
+}
+
+TEST_CASE("dot parser reports the line of the error", "[dot parser]")
+{
+    const auto check_error = [](std::string_view text, std::string message) {
+        try {
+            parse_simplified_dot(text);
+            FAIL("no exception");
+        }
+        catch (const std::runtime_error& e) {
+            REQUIRE(e.what() == message);
+        }
+    };
+    check_error("digraph G {\n\n \"a\" -> \"b\"\n}",
+        "dotfile error on line 3: \"a\" -> \"b\"");
+    check_error("graph G {\n}", "dotfile error on line 1:graph G {");
+    check_error("digraph G {\n\"\" -> \"b\";\n}",
+        "dotfile error on line 2:\"\" -> \"b\";");
+    check_error("digraph G {\n \"a\" -> \"b\";\n",
+        "error in simplified dot format");
+    check_error("\n", "error in simplified dot format");
+}
+
+TEST_CASE("parallel dot parser gives the result of the sequential one",
+    "[dot parser]")
+{
+    std::string text = "\ndigraph G {\n";
+    for (int i = 0; i < 2000; ++i) {
+        text += "  \"" + std::to_string(i) + "\" -> \""
+            + std::to_string(i + 1) + "\";\n";
+        if (i % 7 == 0) {
+            text += "\n";
+        }
+    }
+    text += "}\n";
+    job_sheduler::thread_pool pool(4);
+    for (size_t chunk_size : { 1, 100, 4096, 1 << 20 }) {
+        REQUIRE(parse_simplified_dot(text, pool, chunk_size)
+            == parse_simplified_dot(text));
+    }
+}
+
+TEST_CASE("parallel dot parser reports the line of the error",
+    "[dot parser]")
+{
+    std::string text = "digraph G {\n";
+    for (int i = 0; i < 1000; ++i) {
+        text += "\"a\" -> \"b\";\n";
+    }
+    job_sheduler::thread_pool pool(4);
+    SECTION("invalid edge")
+    {
+        text += "\"a\" -> ;\n}\n\"x\";\n";
+        REQUIRE_THROWS_WITH(parse_simplified_dot(text, pool, 16),
+            "dotfile error on line 1002:\"a\" -> ;");
+    }
+    SECTION("lines after the end are ignored")
+    {
+        text += "}\n\"x\";\n";
+        REQUIRE(parse_simplified_dot(text, pool, 16).size() == 1000);
+    }
+    SECTION("missing end")
+    {
+        REQUIRE_THROWS_WITH(parse_simplified_dot(text, pool, 16),
+            "error in simplified dot format");
+    }
+    SECTION("empty text")
+    {
+        REQUIRE(parse_simplified_dot(""sv, pool).empty());
+    }
+}
+
+TEST_CASE("dot parser result can be allocated from a memory resource",
+    "[dot parser]")
+{
+    constexpr auto dot = R"#(digraph G {
+    "a long label that is not a short string" -> "b";
+    "b" -> "c";
+})#";
+    test_utils::counting_resource resource;
+    const auto views = parse_simplified_dot(std::string_view(dot), &resource);
+    REQUIRE(views.get_allocator().resource() == &resource);
+    REQUIRE(views.size() == 2);
+    REQUIRE(views[1] == edge_view("b", "c"));
+    REQUIRE(resource.allocations() != 0);
+    std::istringstream stream(dot);
+    const auto owning = parse_simplified_dot(stream, &resource);
+    REQUIRE(owning.size() == 2);
+    REQUIRE(owning[0].first == "a long label that is not a short string");
+    REQUIRE(owning[0].first.get_allocator().resource() == &resource);
+    REQUIRE(owning.get_allocator().resource() == &resource);
+}
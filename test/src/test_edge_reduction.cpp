@@ -0,0 +1,163 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <edge_reduction.h>
+#include <job_graph.h>
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+namespace {
+
+// random dag on num_vertices vertices, edges go from lower to higher ids
+edge_list create_random_dag(vertex_id num_vertices, size_t num_edges)
+{
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<vertex_id> vertex(0, num_vertices - 1);
+    edge_list res;
+    while (res.size() < num_edges) {
+        const auto from = vertex(gen);
+        const auto to = vertex(gen);
+        if (from != to) {
+            res.emplace_back(std::min(from, to), std::max(from, to));
+        }
+    }
+    return res;
+}
+
+// vertices reachable from every vertex by depth first search
+std::vector<std::vector<bool>> reachability(
+    const edge_list& edges, size_t num_vertices)
+{
+    std::vector<std::vector<vertex_id>> successors(num_vertices);
+    for (const auto& [ from, to ] : edges) {
+        successors[from].push_back(to);
+    }
+    std::vector<std::vector<bool>> res(
+        num_vertices, std::vector<bool>(num_vertices));
+    for (vertex_id v = 0; v < num_vertices; ++v) {
+        std::vector<vertex_id> stack{ v };
+        while (!stack.empty()) {
+            const auto u = stack.back();
+            stack.pop_back();
+            for (auto s : successors[u]) {
+                if (!res[v][s]) {
+                    res[v][s] = true;
+                    stack.push_back(s);
+                }
+            }
+        }
+    }
+    return res;
+}
+
+template <typename T>
+std::vector<std::vector<T>> sorted(std::vector<std::vector<T>> schedule)
+{
+    for (auto& level : schedule) {
+        std::sort(level.begin(), level.end());
+    }
+    return schedule;
+}
+
+} // namespace
+
+TEST_CASE("duplicate edges are removed in place", "[edge_reduction]")
+{
+    edge_list edges{ { 0, 1 }, { 1, 2 }, { 0, 1 }, { 2, 3 }, { 1, 2 },
+        { 0, 1 } };
+    REQUIRE(remove_duplicate_edges(edges) == 3);
+    REQUIRE(edges == edge_list{ { 0, 1 }, { 1, 2 }, { 2, 3 } });
+    REQUIRE(remove_duplicate_edges(edges) == 0);
+}
+
+TEST_CASE("transitive edges are removed", "[edge_reduction]")
+{
+    // 0 -> 1 -> 2 -> 3 with shortcuts and a duplicate
+    edge_list edges{ { 0, 2 }, { 0, 1 }, { 1, 2 }, { 2, 3 }, { 0, 3 },
+        { 1, 2 }, { 1, 3 } };
+    REQUIRE(remove_transitive_edges(edges, 4) == 4);
+    REQUIRE(edges == edge_list{ { 0, 1 }, { 1, 2 }, { 2, 3 } });
+
+    edge_list diamond{ { 0, 1 }, { 0, 2 }, { 1, 3 }, { 2, 3 } };
+    REQUIRE(remove_transitive_edges(diamond, 4) == 0);
+}
+
+TEST_CASE("empty graphs are reduced", "[edge_reduction]")
+{
+    edge_list edges;
+    REQUIRE(remove_transitive_edges(edges, 0) == 0);
+    REQUIRE(edges.empty());
+    REQUIRE(remove_transitive_edges(edges, 3) == 0);
+    REQUIRE(edges.empty());
+}
+
+TEST_CASE("transitive reduction keeps the reachability",
+    "[edge_reduction]")
+{
+    const vertex_id num_vertices = 300;
+    const auto edges = create_random_dag(num_vertices, 3000);
+    auto reduced = edges;
+    const auto removed = remove_transitive_edges(reduced, num_vertices);
+    REQUIRE(removed > 0);
+    REQUIRE(reduced.size() + removed == edges.size());
+    REQUIRE(reachability(reduced, num_vertices)
+        == reachability(edges, num_vertices));
+    // no edge of the result is implied by the others
+    auto again = reduced;
+    REQUIRE(remove_transitive_edges(again, num_vertices) == 0);
+    // blocks of 64 columns give the same result
+    auto blocked = edges;
+    REQUIRE(remove_transitive_edges(blocked, num_vertices, 1) == removed);
+    REQUIRE(blocked == reduced);
+}
+
+TEST_CASE("graphs with cycles only lose their duplicates",
+    "[edge_reduction]")
+{
+    edge_list edges{ { 0, 1 }, { 1, 2 }, { 2, 1 }, { 0, 2 }, { 0, 1 } };
+    REQUIRE(remove_transitive_edges(edges, 3) == 1);
+    REQUIRE(edges == edge_list{ { 0, 1 }, { 1, 2 }, { 2, 1 }, { 0, 2 } });
+}
+
+TEST_CASE("make_graph reduces the edges", "[edge_reduction]")
+{
+    const auto edges = { std::make_pair("a"s, "b"s),
+        std::make_pair("b"s, "c"s), std::make_pair("a"s, "c"s),
+        std::make_pair("a"s, "b"s), std::make_pair("c"s, "d"s) };
+    auto graph = make_graph(edges);
+    auto deduplicated = make_graph(
+        edges, std::pmr::get_default_resource(), edge_reduction::duplicates);
+    auto reduced = make_graph(
+        edges, std::pmr::get_default_resource(), edge_reduction::transitive);
+    REQUIRE(graph.num_edges() == 5);
+    REQUIRE(deduplicated.num_edges() == 4);
+    REQUIRE(reduced.num_edges() == 3);
+    REQUIRE(reduced.num_vertices() == 4);
+    REQUIRE(graph.num_reduced_edges() == 0);
+    REQUIRE(deduplicated.num_reduced_edges() == 1);
+    REQUIRE(reduced.num_reduced_edges() == 2);
+    const auto expected = sorted(graph.get_full_schedule());
+    REQUIRE(sorted(deduplicated.get_full_schedule()) == expected);
+    REQUIRE(sorted(reduced.get_full_schedule()) == expected);
+}
+
+TEST_CASE("reduced random graphs have the same schedule",
+    "[edge_reduction]")
+{
+    const vertex_id num_vertices = 1000;
+    const auto edges = create_random_dag(num_vertices, 8000);
+    auto graph = make_graph(edges.cbegin(), edges.cend());
+    auto reduced = make_graph(edges.cbegin(), edges.cend(),
+        std::pmr::get_default_resource(), edge_reduction::transitive);
+    REQUIRE(reduced.num_edges() < graph.num_edges());
+    REQUIRE(sorted(reduced.get_full_schedule())
+        == sorted(graph.get_full_schedule()));
+}
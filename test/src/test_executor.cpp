@@ -0,0 +1,138 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <executor.h>
+#include <job_graph.h>
+
+#include "test_graphs.h"
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+using test_utils::create_reference_graph;
+
+TEST_CASE("executor runs every job after its dependencies", "[executor]")
+{
+    std::vector<std::pair<int, int>> edges;
+    for (int i = 0; i < 500; ++i) {
+        edges.emplace_back(i / 2, i + 1);
+        edges.emplace_back(i / 3, i + 1);
+    }
+    auto graph = make_graph(edges.cbegin(), edges.cend());
+    std::vector<std::atomic<bool>> done(501);
+    std::atomic<bool> order_ok{ true };
+    auto res = execute(graph,
+        [&](int v) {
+            if (v > 0 && (!done[(v - 1) / 2] || !done[(v - 1) / 3])) {
+                order_ok = false;
+            }
+            done[v] = true;
+        },
+        4);
+    REQUIRE(order_ok);
+    REQUIRE(res.all_succeeded());
+    REQUIRE(res.status.size() == 501);
+    // the graph itself is not scheduled by the execution
+    REQUIRE(graph.num_vertices() == 501);
+}
+
+TEST_CASE("executor has no barrier between levels", "[executor]")
+{
+    // c can only finish after d ran, d is on the level after c
+    auto graph = make_graph({ std::make_pair("a"s, "d"s),
+        std::make_pair("c"s, "e"s), std::make_pair("b"s, "c"s) });
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool d_done = false;
+    bool c_waited = false;
+    auto res = execute(graph,
+        [&](const std::string& v) {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (v == "c") {
+                c_waited = cv.wait_for(lock, 10s, [&] { return d_done; });
+            }
+            if (v == "d") {
+                d_done = true;
+                cv.notify_all();
+            }
+        },
+        2);
+    REQUIRE(c_waited);
+    REQUIRE(res.all_succeeded());
+}
+
+TEST_CASE("executor skips the jobs depending on a failed job", "[executor]")
+{
+    auto graph = create_reference_graph();
+    thread_pool pool(3);
+    std::atomic<int> runs{ 0 };
+    auto res = execute(graph,
+        [&](const std::string& v) {
+            ++runs;
+            if (v == "g") {
+                throw std::runtime_error("job g failed");
+            }
+        },
+        pool);
+    const auto status
+        = [&](const char* v) { return res.status[*graph.id_of(v)]; };
+    REQUIRE(status("g") == job_status::failed);
+    REQUIRE(status("h") == job_status::skipped);
+    REQUIRE(status("i") == job_status::skipped);
+    REQUIRE(status("j") == job_status::skipped);
+    REQUIRE(status("f") == job_status::skipped);
+    REQUIRE(status("a") == job_status::succeeded);
+    REQUIRE(status("e") == job_status::succeeded);
+    REQUIRE(runs == 6);
+    REQUIRE(res.count(job_status::skipped) == 4);
+    REQUIRE(!res.all_succeeded());
+    REQUIRE(res.errors[*graph.id_of("g")]);
+    REQUIRE_THROWS_WITH(res.rethrow_failure(), "job g failed");
+}
+
+TEST_CASE("executor does not run jobs on a cycle", "[executor]")
+{
+    auto graph = make_graph({ std::make_pair(1, 2), std::make_pair(2, 3),
+        std::make_pair(3, 2) });
+    auto res = execute(graph, [](int) {}, 2);
+    REQUIRE(res.status[*graph.id_of(1)] == job_status::succeeded);
+    REQUIRE(res.count(job_status::not_run) == 2);
+}
+
+TEST_CASE("executor does not run removed vertices", "[executor]")
+{
+    auto graph = create_reference_graph();
+    graph.remove_vertex("g");
+    std::atomic<int> runs{ 0 };
+    auto res = execute(graph, [&](const std::string&) { ++runs; }, 2);
+    REQUIRE(runs == 9);
+    REQUIRE(res.status[*graph.id_of("h")] == job_status::succeeded);
+    REQUIRE(res.count(job_status::removed) == 1);
+    REQUIRE(res.all_succeeded());
+}
+
+TEST_CASE("work stealing pool runs tasks posted by tasks", "[executor]")
+{
+    std::atomic<int> counter{ 0 };
+    {
+        thread_pool pool(4);
+        for (int i = 0; i < 10; ++i) {
+            pool.post([&] {
+                for (int j = 0; j < 100; ++j) {
+                    pool.post([&] { ++counter; });
+                }
+            });
+        }
+    }
+    REQUIRE(counter == 1000);
+}
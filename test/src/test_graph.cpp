@@ -2,18 +2,17 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <job_graph.h>
 
+#include "test_graphs.h"
+
 using namespace std::literals;
 
 using namespace job_sheduler;
 
-auto create_test_graph()
-{
-    return make_graph({ std::make_pair("a"s, "b"s), std::make_pair("b"s, "c"s),
-        std::make_pair("b"s, "d"s) });
-}
+using test_utils::create_test_graph;
 
 TEST_CASE("test graph construction", "[graph]")
 {
@@ -131,3 +130,104 @@ TEST_CASE("shedule on the reference graph", "[graph]")
     REQUIRE(sched[3][0] == "j"s);
     REQUIRE(sched[4][0] == "f"s);
 }
+
+TEST_CASE("schedule depth of a vertex is its longest path from an entry point",
+    "[graph]")
+{
+    // chain 0->1->...->99 with shortcuts 0->k and duplicated chain edges
+    std::vector<std::pair<int, int>> edges;
+    for (int i = 0; i < 99; ++i) {
+        edges.emplace_back(i, i + 1);
+        edges.emplace_back(i, i + 1);
+        edges.emplace_back(0, i + 1);
+    }
+    auto graph = make_graph(edges.cbegin(), edges.cend());
+    REQUIRE(graph.num_vertices() == 100);
+    auto sched = graph.get_full_schedule();
+    REQUIRE(graph.is_done());
+    REQUIRE(sched.size() == 100);
+    for (size_t i = 0; i < sched.size(); ++i) {
+        REQUIRE(sched[i].size() == 1);
+        REQUIRE(sched[i][0] == static_cast<int>(i));
+    }
+}
+
+TEST_CASE("scheduled vertices can't be found in the graph", "[graph]")
+{
+    auto graph = create_test_graph();
+    graph.next_schedule();
+    REQUIRE(graph.num_vertices() == 3);
+    REQUIRE(graph.find("a") == graph.end());
+    REQUIRE(graph.find("b") != graph.end());
+}
+
+TEST_CASE("cycle behind the entry points is reported during scheduling",
+    "[graph]")
+{
+    auto graph = make_graph({ std::make_pair("a"s, "b"s),
+        std::make_pair("b"s, "c"s), std::make_pair("c"s, "b"s) });
+    REQUIRE_THROWS(graph.next_schedule());
+}
+
+TEST_CASE("vertices are interned to ids in order of appearance", "[graph]")
+{
+    auto graph = make_graph({ std::make_pair("b"s, "a"s),
+        std::make_pair("a"s, "c"s), std::make_pair("b"s, "c"s) });
+    REQUIRE(graph.storage().size() == 3);
+    REQUIRE(graph.id_of("b"s) == vertex_id(0));
+    REQUIRE(graph.id_of("a"s) == vertex_id(1));
+    REQUIRE(graph.id_of("c"s) == vertex_id(2));
+    REQUIRE(!graph.id_of("d"s));
+    REQUIRE(graph.vertex_at(2) == "c"s);
+}
+
+TEST_CASE("id mapping stays valid after scheduling", "[graph]")
+{
+    auto graph = create_test_graph();
+    graph.get_full_schedule();
+    const auto id = graph.id_of("c"s);
+    REQUIRE(id);
+    REQUIRE(graph.vertex_at(*id) == "c"s);
+}
+
+TEST_CASE("graph can be built from an existing storage", "[graph]")
+{
+    using storage = adjacency_list_storage<int>;
+    graph<int> g(storage({ 3, 1, 2 }, { { 0, 1 }, { 1, 2 } }));
+    REQUIRE(g.id_of(2) == vertex_id(2));
+    REQUIRE(g.next_schedule() == std::vector<int>{ 3 });
+    REQUIRE_THROWS(graph<int>(storage({ 1, 1 }, {})));
+}
+
+TEST_CASE("vertices of string graphs can be looked up by string_view",
+    "[graph]")
+{
+    auto graph = create_test_graph();
+    const auto key = "abcd"sv.substr(2, 1);
+    REQUIRE(graph.find(key) != graph.end());
+    REQUIRE(graph.id_of(key) == graph.id_of("c"s));
+    REQUIRE(!graph.id_of("cd"sv));
+}
+
+TEST_CASE("state of vertices follows the schedule", "[graph]")
+{
+    auto graph = create_test_graph();
+    REQUIRE(graph.state_of("a"sv) == vertex_state::ready);
+    REQUIRE(graph.state_of("b"sv) == vertex_state::pending);
+    REQUIRE(!graph.state_of("x"sv));
+    graph.next_schedule();
+    REQUIRE(graph.state_of("a"sv) == vertex_state::scheduled);
+    REQUIRE(graph.state_of("b"sv) == vertex_state::ready);
+    REQUIRE(graph.state_of("c"sv) == vertex_state::pending);
+    graph.next_schedule();
+    REQUIRE(graph.state(*graph.id_of("c"sv)) == vertex_state::ready);
+    REQUIRE(graph.state(*graph.id_of("b"sv)) == vertex_state::scheduled);
+}
+
+TEST_CASE("vertices of integral graphs are found by value", "[graph]")
+{
+    auto graph = make_graph({ std::make_pair(1, 2), std::make_pair(2, 3) });
+    REQUIRE(graph.find(3) != graph.end());
+    REQUIRE(graph.find(4) == graph.end());
+    REQUIRE(graph.state_of(2) == vertex_state::pending);
+}
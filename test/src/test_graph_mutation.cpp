@@ -0,0 +1,220 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <job_graph.h>
+
+#include "test_graphs.h"
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+using test_utils::create_test_graph;
+
+namespace {
+
+template <typename GraphT, typename KeyT>
+size_t level_of(const GraphT& graph, const KeyT& key)
+{
+    return graph.level(*graph.id_of(key));
+}
+
+template <typename T>
+std::vector<std::vector<T>> sorted(std::vector<std::vector<T>> schedule)
+{
+    for (auto& level : schedule) {
+        std::sort(level.begin(), level.end());
+    }
+    return schedule;
+}
+
+bool reaches(const std::vector<std::pair<int, int>>& edges, int from, int to)
+{
+    std::vector<int> stack{ from };
+    std::vector<int> visited{ from };
+    while (!stack.empty()) {
+        const auto v = stack.back();
+        stack.pop_back();
+        for (const auto & [ a, b ] : edges) {
+            if (a != v || std::count(visited.begin(), visited.end(), b)) {
+                continue;
+            }
+            if (b == to) {
+                return true;
+            }
+            visited.push_back(b);
+            stack.push_back(b);
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+TEST_CASE("levels are the depths of the vertices", "[mutation]")
+{
+    auto graph = create_test_graph();
+    REQUIRE(level_of(graph, "a") == 0);
+    REQUIRE(level_of(graph, "b") == 1);
+    REQUIRE(level_of(graph, "c") == 2);
+    REQUIRE(level_of(graph, "d") == 2);
+    graph.next_schedule();
+    REQUIRE(level_of(graph, "a") == 0);
+    REQUIRE(level_of(graph, "c") == 2);
+}
+
+TEST_CASE("added vertices are part of the next level", "[mutation]")
+{
+    auto graph = create_test_graph();
+    graph.next_schedule();
+    const auto res = graph.add_vertex("x"s);
+    REQUIRE(res.second);
+    REQUIRE(res.first == vertex_id(4));
+    REQUIRE(graph.add_vertex("x"s) == std::make_pair(vertex_id(4), false));
+    REQUIRE(graph.num_vertices() == 4);
+    REQUIRE(graph.state_of("x") == vertex_state::ready);
+    REQUIRE(graph.level(res.first) == 1);
+    REQUIRE(graph.find("x") != graph.end());
+    REQUIRE(sorted(graph.get_full_schedule())
+        == std::vector<std::vector<std::string>>{ { "b", "x" }, { "c", "d" } });
+}
+
+TEST_CASE("added edges move the descendants to later levels", "[mutation]")
+{
+    auto graph = create_test_graph();
+    graph.add_edge("d"s, "c"s);
+    REQUIRE(level_of(graph, "c") == 3);
+    graph.add_edge("x"s, "a"s);
+    REQUIRE(level_of(graph, "x") == 0);
+    REQUIRE(level_of(graph, "a") == 1);
+    REQUIRE(level_of(graph, "b") == 2);
+    REQUIRE(level_of(graph, "d") == 3);
+    REQUIRE(level_of(graph, "c") == 4);
+    REQUIRE(graph.state_of("a") == vertex_state::pending);
+    REQUIRE(graph.num_edges() == 5);
+    REQUIRE(graph.get_full_schedule()
+        == std::vector<std::vector<std::string>>{
+               { "x" }, { "a" }, { "b" }, { "d" }, { "c" } });
+}
+
+TEST_CASE("edges from scheduled vertices don't delay the schedule",
+    "[mutation]")
+{
+    auto graph = create_test_graph();
+    graph.next_schedule();
+    graph.add_edge("a"s, "y"s);
+    REQUIRE(graph.state_of("y") == vertex_state::ready);
+    REQUIRE(level_of(graph, "y") == 1);
+    REQUIRE_THROWS_AS(graph.add_edge("b"s, "a"s), std::invalid_argument);
+}
+
+TEST_CASE("edges closing a cycle are rejected", "[mutation]")
+{
+    auto graph = create_test_graph();
+    REQUIRE_THROWS_AS(graph.add_edge("c"s, "a"s), std::invalid_argument);
+    REQUIRE_THROWS_AS(graph.add_edge("d"s, "b"s), std::invalid_argument);
+    REQUIRE_THROWS_AS(graph.add_edge("e"s, "e"s), std::invalid_argument);
+    REQUIRE(!graph.id_of("e"));
+    REQUIRE(graph.num_edges() == 3);
+    REQUIRE(level_of(graph, "c") == 2);
+    graph.add_edge("c"s, "d"s);
+    REQUIRE_THROWS_AS(graph.add_edge("d"s, "c"s), std::invalid_argument);
+    REQUIRE(level_of(graph, "d") == 3);
+}
+
+TEST_CASE("removed edges move the descendants to earlier levels",
+    "[mutation]")
+{
+    auto graph = create_test_graph();
+    graph.add_edge("c"s, "d"s);
+    REQUIRE(level_of(graph, "d") == 3);
+    REQUIRE(!graph.remove_edge("d", "c"));
+    REQUIRE(!graph.remove_edge("d", "x"));
+    REQUIRE(graph.remove_edge("c", "d"));
+    REQUIRE(level_of(graph, "d") == 2);
+    REQUIRE(graph.remove_edge("a", "b"));
+    REQUIRE(level_of(graph, "b") == 0);
+    REQUIRE(level_of(graph, "c") == 1);
+    REQUIRE(graph.state_of("b") == vertex_state::ready);
+    REQUIRE(graph.num_edges() == 2);
+    REQUIRE(sorted(graph.get_full_schedule())
+        == std::vector<std::vector<std::string>>{ { "a", "b" }, { "c", "d" } });
+}
+
+TEST_CASE("removed vertices leave the schedule", "[mutation]")
+{
+    auto graph = create_test_graph();
+    REQUIRE(graph.remove_vertex("b"));
+    REQUIRE(!graph.remove_vertex("b"));
+    REQUIRE(!graph.id_of("b"));
+    REQUIRE(graph.find("b") == graph.end());
+    REQUIRE(graph.state(1) == vertex_state::removed);
+    REQUIRE(graph.num_vertices() == 3);
+    REQUIRE(graph.num_edges() == 0);
+    REQUIRE(level_of(graph, "c") == 0);
+    REQUIRE(graph.state_of("c") == vertex_state::ready);
+    // the name can be used again, with a new id
+    graph.add_edge("c"s, "b"s);
+    REQUIRE(graph.id_of("b") == vertex_id(4));
+    REQUIRE(sorted(graph.get_full_schedule())
+        == std::vector<std::vector<std::string>>{ { "a", "c", "d" }, { "b" } });
+}
+
+TEST_CASE("ready vertices can be removed", "[mutation]")
+{
+    auto graph = create_test_graph();
+    graph.next_schedule();
+    REQUIRE(graph.remove_vertex("b"));
+    REQUIRE(graph.remove_vertex("a"));
+    REQUIRE(graph.num_vertices() == 2);
+    REQUIRE(sorted(graph.get_full_schedule())
+        == std::vector<std::vector<std::string>>{ { "c", "d" } });
+}
+
+TEST_CASE("incremental levels match the levels of a rebuilt graph",
+    "[mutation]")
+{
+    std::mt19937 rng(42);
+    graph<int> g(adjacency_list_storage<int>({}, {}));
+    std::vector<std::pair<int, int>> edges;
+    for (int step = 0; step < 2000; ++step) {
+        const int from = static_cast<int>(rng() % 60);
+        const int to = static_cast<int>(rng() % 60);
+        if (rng() % 4 == 0 && !edges.empty()) {
+            const auto i = rng() % edges.size();
+            REQUIRE(g.remove_edge(edges[i].first, edges[i].second));
+            edges.erase(edges.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        else if (from != to) {
+            try {
+                g.add_edge(from, to);
+                edges.emplace_back(from, to);
+            }
+            catch (const std::invalid_argument&) {
+                REQUIRE(reaches(edges, to, from));
+            }
+        }
+    }
+    std::pmr::vector<int> vertices;
+    for (vertex_id id = 0; id < g.storage().size(); ++id) {
+        vertices.push_back(g.vertex_at(id));
+    }
+    edge_list ids;
+    for (const auto & [ from, to ] : edges) {
+        ids.emplace_back(*g.id_of(from), *g.id_of(to));
+    }
+    graph<int> rebuilt(adjacency_list_storage<int>(vertices, ids));
+    REQUIRE(g.num_edges() == rebuilt.num_edges());
+    for (vertex_id id = 0; id < g.storage().size(); ++id) {
+        REQUIRE(g.level(id) == rebuilt.level(id));
+    }
+    REQUIRE(sorted(g.get_full_schedule())
+        == sorted(rebuilt.get_full_schedule()));
+}
@@ -0,0 +1,136 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <graph_storage.h>
+#include <job_graph.h>
+
+#include "counting_resource.h"
+#include "test_graphs.h"
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+namespace {
+
+std::vector<vertex_id> to_vector(id_range r)
+{
+    return std::vector<vertex_id>(r.begin(), r.end());
+}
+
+} // namespace
+
+TEST_CASE("csr storage lays out edges grouped by vertex", "[storage]")
+{
+    const edge_list edges{ { 2, 0 }, { 0, 1 }, { 0, 2 }, { 1, 2 } };
+    csr_storage<std::string> csr({ "a"s, "b"s, "c"s }, edges);
+    REQUIRE(csr.size() == 3);
+    REQUIRE(csr.num_edges() == 4);
+    REQUIRE(csr.elem(1) == "b"s);
+    REQUIRE(to_vector(csr.out_edges(0)) == std::vector<vertex_id>{ 1, 2 });
+    REQUIRE(to_vector(csr.out_edges(1)) == std::vector<vertex_id>{ 2 });
+    REQUIRE(to_vector(csr.out_edges(2)) == std::vector<vertex_id>{ 0 });
+    REQUIRE(to_vector(csr.in_edges(0)) == std::vector<vertex_id>{ 2 });
+    REQUIRE(to_vector(csr.in_edges(2)) == std::vector<vertex_id>{ 0, 1 });
+    REQUIRE(csr.out_offsets()
+        == csr_storage<std::string>::offsets_t{ 0, 2, 3, 4 });
+}
+
+TEST_CASE("csr storage rejects inconsistent arrays", "[storage]")
+{
+    REQUIRE_THROWS(
+        csr_storage<int>({ 1, 2 }, { 0, 1 }, { 1 }, { 0, 0, 1 }, { 0 }));
+}
+
+TEST_CASE("adjacency list and csr storage agree", "[storage]")
+{
+    const edge_list edges{ { 0, 1 }, { 0, 2 }, { 1, 2 }, { 1, 2 } };
+    adjacency_list_storage<int> list({ 10, 11, 12 }, edges);
+    csr_storage<int> csr({ 10, 11, 12 }, edges);
+    REQUIRE(list.num_edges() == csr.num_edges());
+    for (vertex_id id = 0; id < 3; ++id) {
+        REQUIRE(list.elem(id) == csr.elem(id));
+        REQUIRE(to_vector(list.out_edges(id)) == to_vector(csr.out_edges(id)));
+        REQUIRE(to_vector(list.in_edges(id)) == to_vector(csr.in_edges(id)));
+    }
+}
+
+TEST_CASE("shedule on the reference graph with csr storage", "[storage]")
+{
+    auto graph = test_utils::create_reference_graph<csr_storage>();
+    REQUIRE(graph.num_vertices() == 10);
+    REQUIRE(graph.num_edges() == 11);
+    REQUIRE(graph.find("e") != graph.end());
+    auto sched = graph.get_full_schedule();
+    REQUIRE(graph.is_done());
+    REQUIRE(sched.size() == 5);
+    for (auto& level : sched) {
+        std::sort(level.begin(), level.end());
+    }
+    REQUIRE(sched[0] == std::vector<std::string>{ "a", "b" });
+    REQUIRE(sched[1] == std::vector<std::string>{ "c", "d", "g" });
+    REQUIRE(sched[2] == std::vector<std::string>{ "e", "h", "i" });
+    REQUIRE(sched[3] == std::vector<std::string>{ "j" });
+    REQUIRE(sched[4] == std::vector<std::string>{ "f" });
+}
+
+TEST_CASE("job graph with csr storage and no entry point can't be created",
+    "[storage]")
+{
+    REQUIRE_THROWS(make_graph<csr_storage>(
+        { std::make_pair(1, 2), std::make_pair(2, 1) }));
+}
+
+TEST_CASE("adjacency list storage can be modified", "[storage]")
+{
+    adjacency_list_storage<int> list({ 10, 11 }, { { 0, 1 } });
+    REQUIRE(list.add_vertex(12) == vertex_id(2));
+    list.add_edge(1, 2);
+    list.add_edge(0, 2);
+    list.add_edge(0, 2);
+    REQUIRE(list.num_edges() == 4);
+    REQUIRE(to_vector(list.in_edges(2)) == std::vector<vertex_id>{ 1, 0, 0 });
+    REQUIRE(list.remove_edge(0, 2));
+    REQUIRE(!list.remove_edge(2, 0));
+    REQUIRE(to_vector(list.in_edges(2)) == std::vector<vertex_id>{ 1, 0 });
+    REQUIRE(list.num_edges() == 3);
+    list.remove_edges(1);
+    REQUIRE(list.num_edges() == 1);
+    REQUIRE(to_vector(list.out_edges(0)) == std::vector<vertex_id>{ 2 });
+    REQUIRE(to_vector(list.in_edges(2)) == std::vector<vertex_id>{ 0 });
+    REQUIRE(list.out_edges(1).empty());
+    REQUIRE(list.size() == 3);
+}
+
+TEST_CASE("graph storage is allocated from the given memory resource",
+    "[storage]")
+{
+    test_utils::counting_resource upstream;
+    std::pmr::monotonic_buffer_resource arena(&upstream);
+    const std::vector<std::pair<std::pmr::string, std::pmr::string>> edges{
+        { "a vertex with a long label", "b" }, { "b", "c" }
+    };
+    auto list_graph = make_graph(edges.cbegin(), edges.cend(), &arena);
+    REQUIRE(list_graph.storage().resource() == &arena);
+    REQUIRE(list_graph.vertex_at(0).get_allocator().resource() == &arena);
+    auto csr_graph
+        = make_graph<csr_storage>(edges.cbegin(), edges.cend(), &arena);
+    REQUIRE(csr_graph.storage().resource() == &arena);
+    REQUIRE(csr_graph.vertex_at(0).get_allocator().resource() == &arena);
+    REQUIRE(upstream.allocations() != 0);
+
+    // copies and their modifications stay in the arena
+    auto copy = list_graph;
+    copy.add_edge(
+        std::pmr::string("c"), std::pmr::string("another long label"));
+    REQUIRE(&copy.storage() != &list_graph.storage());
+    REQUIRE(copy.storage().resource() == &arena);
+    REQUIRE(copy.vertex_at(3).get_allocator().resource() == &arena);
+    REQUIRE(copy.get_full_schedule().size() == 4);
+    REQUIRE(upstream.deallocations() == 0);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include <graph_storage.h>
+#include <job_graph.h>
+
+namespace test_utils {
+
+/// \brief graph of 4 jobs: a -> b, b -> c and b -> d
+inline auto create_test_graph()
+{
+    using namespace std::literals;
+    return job_sheduler::make_graph({ std::make_pair("a"s, "b"s),
+        std::make_pair("b"s, "c"s), std::make_pair("b"s, "d"s) });
+}
+
+/// \brief graph of 10 jobs and 11 dependencies shared by the tests, its
+/// levels are {a, b}, {g, c, d}, {h, i, e}, {j}, {f}
+template <template <typename> class StorageT
+    = job_sheduler::adjacency_list_storage>
+auto create_reference_graph()
+{
+    using namespace std::literals;
+    return job_sheduler::make_graph<StorageT>({ std::make_pair("a"s, "g"s),
+        std::make_pair("b"s, "c"s), std::make_pair("b"s, "d"s),
+        std::make_pair("g"s, "h"s), std::make_pair("g"s, "i"s),
+        std::make_pair("c"s, "e"s), std::make_pair("d"s, "e"s),
+        std::make_pair("h"s, "j"s), std::make_pair("i"s, "j"s),
+        std::make_pair("e"s, "f"s), std::make_pair("j"s, "f"s) });
+}
+
+} // namespace test_utils
@@ -0,0 +1,46 @@
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+#include <system_error>
+
+#include <input_buffer.h>
+
+#include "temp_file.h"
+
+using namespace job_sheduler::utils;
+
+using test_utils::temp_file;
+
+TEST_CASE("input buffer maps regular files", "[input buffer]")
+{
+    temp_file file("digraph G {\n}\n");
+    auto buffer = input_buffer::map_file(file.path);
+    REQUIRE(buffer.is_mapped());
+    REQUIRE(buffer.view() == "digraph G {\n}\n");
+    auto moved = std::move(buffer);
+    REQUIRE(!buffer.is_mapped());
+    REQUIRE(buffer.view().empty());
+    REQUIRE(moved.view() == "digraph G {\n}\n");
+}
+
+TEST_CASE("input buffer of an empty file is empty", "[input buffer]")
+{
+    temp_file file("");
+    auto buffer = input_buffer::map_file(file.path);
+    REQUIRE(buffer.view().empty());
+}
+
+TEST_CASE("input buffer of a missing file throws", "[input buffer]")
+{
+    REQUIRE_THROWS_AS(
+        input_buffer::map_file("/nonexistent/graph.txt"), std::system_error);
+}
+
+TEST_CASE("input buffer reads whole streams", "[input buffer]")
+{
+    std::istringstream iss("digraph G {\n\"a\" -> \"b\";\n}");
+    auto buffer = input_buffer::read_stream(iss);
+    REQUIRE(!buffer.is_mapped());
+    REQUIRE(buffer.view() == "digraph G {\n\"a\" -> \"b\";\n}");
+}
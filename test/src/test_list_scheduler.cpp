@@ -0,0 +1,159 @@
+#include <catch.hpp>
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <job_graph.h>
+#include <list_scheduler.h>
+
+#include "test_graphs.h"
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+using test_utils::create_reference_graph;
+
+namespace {
+
+// precedences are kept and jobs of a worker don't overlap
+template <typename GraphT>
+void check_schedule(const GraphT& graph, const list_schedule& sched)
+{
+    const auto& storage = graph.storage();
+    REQUIRE(sched.jobs.size() == storage.size());
+    for (vertex_id id = 0; id < storage.size(); ++id) {
+        REQUIRE(sched.jobs[id].id == id);
+        for (auto s : storage.out_edges(id)) {
+            REQUIRE(sched.jobs[id].finish <= sched.jobs[s].start);
+        }
+    }
+    size_t count = 0;
+    for (size_t w = 0; w < sched.workers.size(); ++w) {
+        const auto& jobs = sched.workers[w];
+        count += jobs.size();
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            REQUIRE(jobs[i].worker == w);
+            REQUIRE(jobs[i].finish <= sched.makespan);
+            if (i != 0) {
+                REQUIRE(jobs[i - 1].finish <= jobs[i].start);
+            }
+        }
+    }
+    REQUIRE(count == storage.size());
+    REQUIRE(sched.makespan >= sched.critical_path_length);
+}
+
+} // namespace
+
+TEST_CASE("critical path follows the most expensive jobs", "[list_scheduler]")
+{
+    auto graph = make_graph({ std::make_pair("a"s, "b"s),
+        std::make_pair("a"s, "c"s), std::make_pair("b"s, "d"s),
+        std::make_pair("c"s, "d"s) });
+    const std::map<std::string, double> costs{ { "a", 1 }, { "b", 5 },
+        { "c", 2 }, { "d", 1 } };
+    const auto sched = schedule_list(
+        graph, [&](const std::string& v) { return costs.at(v); }, 2);
+    check_schedule(graph, sched);
+    REQUIRE(sched.critical_path_length == 7);
+    REQUIRE(sched.makespan == 7);
+    std::vector<std::string> path;
+    for (auto id : sched.critical_path) {
+        path.push_back(graph.vertex_at(id));
+    }
+    REQUIRE(path == std::vector<std::string>{ "a", "b", "d" });
+    REQUIRE(sched.jobs[*graph.id_of("b")].start == 1);
+    REQUIRE(sched.jobs[*graph.id_of("c")].start == 1);
+    REQUIRE(sched.jobs[*graph.id_of("d")].start == 6);
+}
+
+TEST_CASE("makespan depends on the number of workers", "[list_scheduler]")
+{
+    auto graph = create_reference_graph();
+    const auto unit = [](const std::string&) { return 1; };
+    const auto serial = schedule_list(graph, unit, 1);
+    check_schedule(graph, serial);
+    REQUIRE(serial.makespan == 10);
+    REQUIRE(serial.critical_path.size() == 5);
+    REQUIRE(serial.critical_path_length == 5);
+    const auto wide = schedule_list(graph, unit, 10);
+    check_schedule(graph, wide);
+    REQUIRE(wide.makespan == 5);
+    const auto two = schedule_list(graph, unit, 2);
+    check_schedule(graph, two);
+    REQUIRE(two.makespan <= 6);
+}
+
+TEST_CASE("jobs of the critical path are preferred", "[list_scheduler]")
+{
+    // a long chain and many short independent jobs on two workers, the
+    // chain has to start first to reach the lower bound
+    std::vector<std::pair<int, int>> edges{ { 0, 1 }, { 1, 2 } };
+    for (int i = 10; i < 16; i += 2) {
+        edges.emplace_back(i, i + 1);
+    }
+    auto graph = make_graph(edges.cbegin(), edges.cend());
+    const auto cost = [](int v) { return v < 10 ? 3 : 1; };
+    const auto sched = schedule_list(graph, cost, 2);
+    check_schedule(graph, sched);
+    REQUIRE(sched.critical_path_length == 9);
+    REQUIRE(sched.makespan == 9);
+    REQUIRE(sched.jobs[*graph.id_of(0)].start == 0);
+}
+
+TEST_CASE("zero cost jobs keep their dependencies", "[list_scheduler]")
+{
+    std::vector<std::pair<int, int>> edges;
+    for (int i = 0; i < 50; ++i) {
+        edges.emplace_back(i, i + 1);
+        edges.emplace_back(i / 2, i + 1);
+    }
+    auto graph = make_graph(edges.cbegin(), edges.cend());
+    const auto sched = schedule_list(graph, [](int) { return 0; }, 3);
+    check_schedule(graph, sched);
+    REQUIRE(sched.makespan == 0);
+    REQUIRE(sched.critical_path.front() == *graph.id_of(0));
+}
+
+TEST_CASE("scheduling state of the graph is ignored", "[list_scheduler]")
+{
+    auto graph = create_reference_graph();
+    graph.next_schedule();
+    const auto sched
+        = schedule_list(graph, [](const std::string&) { return 1; }, 2);
+    check_schedule(graph, sched);
+}
+
+TEST_CASE("invalid list schedule requests throw", "[list_scheduler]")
+{
+    auto graph = create_reference_graph();
+    const auto unit = [](const std::string&) { return 1; };
+    REQUIRE_THROWS_AS(schedule_list(graph, unit, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        schedule_list(graph, [](const std::string&) { return -1; }, 2),
+        std::invalid_argument);
+    auto cyclic = make_graph({ std::make_pair("a"s, "b"s),
+        std::make_pair("b"s, "c"s), std::make_pair("c"s, "b"s) });
+    REQUIRE_THROWS_AS(schedule_list(cyclic, unit, 2), std::runtime_error);
+}
+
+TEST_CASE("job costs are parsed per line", "[list_scheduler]")
+{
+    const auto costs
+        = utils::parse_job_costs("\"a\" 1\n\n  \"b c\"\t2.5  \n\"d\" 0");
+    REQUIRE(costs.size() == 3);
+    REQUIRE(costs[0] == utils::cost_view("a", 1));
+    REQUIRE(costs[1] == utils::cost_view("b c", 2.5));
+    REQUIRE(costs[2] == utils::cost_view("d", 0));
+    REQUIRE(utils::parse_job_costs("").empty());
+    REQUIRE_THROWS(utils::parse_job_costs("a 1"));
+    REQUIRE_THROWS(utils::parse_job_costs("\"a\""));
+    REQUIRE_THROWS(utils::parse_job_costs("\"a\" 1x"));
+    REQUIRE_THROWS(utils::parse_job_costs("\"a\" -1"));
+    REQUIRE_THROWS_WITH(utils::parse_job_costs("\"a\" 1\n\"b\" x"),
+        "costs file error on line 2:\"b\" x");
+}
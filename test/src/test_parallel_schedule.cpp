@@ -0,0 +1,109 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <job_graph.h>
+#include <parallel_schedule.h>
+#include <schedule_cursor.h>
+#include <schedule_range.h>
+#include <thread_pool.h>
+
+#include "test_graphs.h"
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+using test_utils::create_reference_graph;
+
+namespace {
+
+// wide random dag, edges go from lower to higher vertices
+auto create_wide_graph(int num_vertices, int num_edges)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> vertex(0, num_vertices - 1);
+    std::vector<std::pair<int, int>> edges;
+    while (static_cast<int>(edges.size()) < num_edges) {
+        const auto from = vertex(gen);
+        const auto to = vertex(gen);
+        if (from != to) {
+            edges.emplace_back(std::min(from, to), std::max(from, to));
+        }
+    }
+    return make_graph(edges.cbegin(), edges.cend());
+}
+
+} // namespace
+
+TEST_CASE("parallel levels are the levels of the graph",
+    "[parallel_schedule]")
+{
+    thread_pool pool(4);
+    auto graph = create_wide_graph(20000, 60000);
+    const auto expected = schedule_cursor(graph).get_full_schedule();
+    // the order within the levels doesn't depend on the split
+    for (size_t grain : { 1, 16, 1000, 100000 }) {
+        parallel_schedule_cursor cursor(graph, pool, grain);
+        REQUIRE(cursor.num_vertices() == graph.num_vertices());
+        REQUIRE(cursor.get_full_schedule() == expected);
+        REQUIRE(cursor.is_done());
+    }
+    REQUIRE(graph.get_full_schedule() == expected);
+}
+
+TEST_CASE("parallel levels keep the order of the graph",
+    "[parallel_schedule]")
+{
+    thread_pool pool(2);
+    auto graph = create_reference_graph();
+    const auto narrow
+        = parallel_schedule_cursor(graph, pool).get_full_schedule();
+    const auto split
+        = parallel_schedule_cursor(graph, pool, 1).get_full_schedule();
+    // duplicate edges release a vertex at the last one
+    auto duplicates = make_graph({ std::make_pair("a"s, "c"s),
+        std::make_pair("a"s, "b"s), std::make_pair("a"s, "c"s),
+        std::make_pair("y"s, "d"s) });
+    const auto expected = schedule_cursor(duplicates).get_full_schedule();
+    const auto duplicates_split
+        = parallel_schedule_cursor(duplicates, pool, 1).get_full_schedule();
+    REQUIRE(narrow == graph.get_full_schedule());
+    REQUIRE(split == narrow);
+    REQUIRE(duplicates_split == expected);
+    REQUIRE(expected
+        == std::vector<std::vector<std::string>>{
+               { "a", "y" }, { "b", "c", "d" } });
+}
+
+TEST_CASE("parallel cursor starts at the scheduling state of the graph",
+    "[parallel_schedule]")
+{
+    thread_pool pool(3);
+    auto graph = create_reference_graph();
+    graph.next_schedule();
+    graph.remove_vertex("h");
+    parallel_schedule_cursor cursor(graph, pool, 1);
+    REQUIRE(cursor.num_vertices() == 7);
+    size_t count = 0;
+    for (const auto& level : schedule_levels(cursor)) {
+        count += level.size();
+    }
+    REQUIRE(count == 7);
+    const auto schedule
+        = parallel_schedule_cursor(graph, pool, 1).get_full_schedule();
+    REQUIRE(schedule == graph.get_full_schedule());
+}
+
+TEST_CASE("parallel cursor reports cycles", "[parallel_schedule]")
+{
+    thread_pool pool(2);
+    const auto graph = make_graph({ std::make_pair("a"s, "b"s),
+        std::make_pair("b"s, "c"s), std::make_pair("c"s, "b"s) });
+    parallel_schedule_cursor cursor(graph, pool, 1);
+    REQUIRE_THROWS(cursor.next_schedule());
+}
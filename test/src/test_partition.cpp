@@ -0,0 +1,268 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <job_graph.h>
+#include <partition.h>
+
+#include "test_graphs.h"
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+using test_utils::create_reference_graph;
+
+namespace {
+
+// layers of the given width, every job depends on degree random jobs of
+// the previous layer
+auto create_layered_graph(int layers, int width, int degree)
+{
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int> pick(0, width - 1);
+    std::vector<std::pair<int, int>> edges;
+    for (int l = 1; l < layers; ++l) {
+        for (int i = 0; i < width; ++i) {
+            for (int d = 0; d < degree; ++d) {
+                edges.emplace_back((l - 1) * width + pick(gen), l * width + i);
+            }
+        }
+    }
+    return make_graph(edges.cbegin(), edges.cend());
+}
+
+// jobs announced by a node, shared by the simulated nodes
+class board {
+public:
+    explicit board(size_t num_jobs)
+        : m_done(num_jobs)
+    {
+    }
+
+    void announce(const std::vector<vertex_id>& jobs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto id : jobs) {
+            m_done[id] = true;
+        }
+        m_cv.notify_all();
+    }
+
+    // false if the jobs are not announced in time, i.e. on a deadlock
+    bool wait(const std::vector<vertex_id>& jobs)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_cv.wait_for(lock, 10s, [&] {
+            return std::all_of(jobs.begin(), jobs.end(),
+                [&](vertex_id id) { return m_done[id]; });
+        });
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<bool> m_done;
+};
+
+struct simulation {
+    // order in which the jobs started and finished, 0 if never
+    std::vector<size_t> started;
+    std::vector<size_t> finished;
+    std::vector<size_t> runs;
+    bool timed_out = false;
+};
+
+// every part runs on its own thread like a node of a cluster, the nodes
+// only share the announced jobs
+template <typename GraphT>
+simulation simulate(const GraphT& graph, const graph_partition& partition)
+{
+    const auto n = graph.storage().size();
+    simulation res{ std::vector<size_t>(n), std::vector<size_t>(n),
+        std::vector<size_t>(n), false };
+    board shared(n);
+    std::atomic<size_t> clock{ 0 };
+    std::vector<char> timed_out(partition.num_parts());
+    std::vector<std::thread> nodes;
+    for (size_t p = 0; p < partition.num_parts(); ++p) {
+        nodes.emplace_back([&, p] {
+            for (const auto& step : partition.schedules[p]) {
+                if (!shared.wait(step.wait_for)) {
+                    timed_out[p] = true;
+                    return;
+                }
+                for (auto id : step.jobs) {
+                    res.started[id] = ++clock;
+                    ++res.runs[id];
+                    res.finished[id] = ++clock;
+                }
+                shared.announce(step.notify);
+            }
+        });
+    }
+    for (auto& node : nodes) {
+        node.join();
+    }
+    res.timed_out = std::count(timed_out.begin(), timed_out.end(), 1) != 0;
+    return res;
+}
+
+template <typename GraphT>
+bool respects_dependencies(const GraphT& graph, const simulation& sim)
+{
+    const auto& storage = graph.storage();
+    for (vertex_id v = 0; v < storage.size(); ++v) {
+        for (auto s : storage.out_edges(v)) {
+            if (sim.finished[v] == 0 || sim.finished[v] >= sim.started[s]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename GraphT>
+size_t count_cut_edges(const GraphT& graph, const graph_partition& partition)
+{
+    size_t res = 0;
+    const auto& storage = graph.storage();
+    for (vertex_id v = 0; v < storage.size(); ++v) {
+        for (auto s : storage.out_edges(v)) {
+            res += partition.part_of[v] != partition.part_of[s] ? 1 : 0;
+        }
+    }
+    return res;
+}
+
+} // namespace
+
+TEST_CASE("every job is in one part", "[partition]")
+{
+    const auto graph = create_reference_graph();
+    const auto partition = partition_graph(graph, 2);
+    REQUIRE(partition.num_parts() == 2);
+    REQUIRE(partition.size(0) + partition.size(1) == 10);
+    size_t num_jobs = 0;
+    for (const auto& steps : partition.schedules) {
+        for (size_t i = 0; i < steps.size(); ++i) {
+            REQUIRE((i == 0 || steps[i - 1].level < steps[i].level));
+            num_jobs += steps[i].jobs.size();
+        }
+    }
+    REQUIRE(num_jobs == 10);
+    REQUIRE(partition.cut_edges == count_cut_edges(graph, partition));
+}
+
+TEST_CASE("levels are split evenly", "[partition]")
+{
+    const auto graph = create_layered_graph(20, 100, 3);
+    const auto partition = partition_graph(graph, 4);
+    for (const auto& steps : partition.schedules) {
+        REQUIRE(steps.size() == 20);
+        for (const auto& step : steps) {
+            // ceil(100 / 4 * 1.1)
+            REQUIRE(step.jobs.size() <= 28);
+        }
+    }
+    REQUIRE(partition.cut_edges == count_cut_edges(graph, partition));
+    // better than assigning the jobs round robin, which cuts 3 / 4
+    REQUIRE(partition.cut_edges < graph.num_edges() / 2);
+}
+
+TEST_CASE("independent chains are not cut", "[partition]")
+{
+    const auto graph = make_graph({ std::make_pair("a1"s, "a2"s),
+        std::make_pair("b1"s, "b2"s), std::make_pair("a2"s, "a3"s),
+        std::make_pair("b2"s, "b3"s) });
+    const auto partition = partition_graph(graph, 2);
+    REQUIRE(partition.cut_edges == 0);
+    REQUIRE(partition.size(0) == 3);
+    REQUIRE(partition.size(1) == 3);
+    for (const auto& steps : partition.schedules) {
+        for (const auto& step : steps) {
+            REQUIRE(step.wait_for.empty());
+            REQUIRE(step.notify.empty());
+        }
+    }
+}
+
+TEST_CASE("simulated nodes run the partitioned schedule", "[partition]")
+{
+    const auto graph = create_layered_graph(30, 64, 4);
+    for (size_t num_parts : { 1, 2, 3, 8 }) {
+        const auto partition = partition_graph(graph, num_parts);
+        const auto sim = simulate(graph, partition);
+        REQUIRE(!sim.timed_out);
+        REQUIRE(std::all_of(sim.runs.begin(), sim.runs.end(),
+            [](size_t runs) { return runs == 1; }));
+        REQUIRE(respects_dependencies(graph, sim));
+    }
+    const auto reference = create_reference_graph();
+    const auto sim = simulate(reference, partition_graph(reference, 3));
+    REQUIRE(!sim.timed_out);
+    REQUIRE(respects_dependencies(reference, sim));
+}
+
+TEST_CASE("removed jobs are not partitioned", "[partition]")
+{
+    auto graph = create_reference_graph();
+    graph.remove_vertex("h");
+    const auto partition = partition_graph(graph, 2);
+    REQUIRE(partition.part_of[*graph.id_of("a")] != graph_partition::no_part);
+    const auto removed = std::count(partition.part_of.begin(),
+        partition.part_of.end(), graph_partition::no_part);
+    REQUIRE(removed == 1);
+    REQUIRE(respects_dependencies(graph, simulate(graph, partition)));
+}
+
+TEST_CASE("partitioning reports cycles", "[partition]")
+{
+    const auto graph = make_graph({ std::make_pair("a"s, "b"s),
+        std::make_pair("b"s, "c"s), std::make_pair("c"s, "b"s) });
+    REQUIRE_THROWS(partition_graph(graph, 2));
+    REQUIRE_THROWS(partition_graph(create_reference_graph(), 0));
+}
+
+TEST_CASE("partitioning rejects a negative imbalance", "[partition]")
+{
+    const auto graph = create_reference_graph();
+    REQUIRE_THROWS_AS(partition_graph(graph, 2, -0.9), std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        partition_graph(graph, 2, std::nan("")), std::invalid_argument);
+    // any imbalance is allowed above 0
+    for (auto imbalance :
+        { 0.0, 1e300, std::numeric_limits<double>::infinity() }) {
+        const auto partition = partition_graph(graph, 2, imbalance);
+        REQUIRE(respects_dependencies(graph, simulate(graph, partition)));
+    }
+}
+
+TEST_CASE("partitions are written part by part", "[partition]")
+{
+    const auto graph = make_graph({ std::make_pair("a"s, "b"s),
+        std::make_pair("a"s, "c"s), std::make_pair("x"s, "c"s) });
+    graph_partition partition;
+    partition.part_of = { 0, 0, 1, 1 };
+    partition.schedules = { { { 0, {}, { 0 }, { 0 } }, { 1, {}, { 1 }, {} } },
+        { { 0, {}, { 3 }, {} }, { 1, { 0 }, { 2 }, {} } } };
+    partition.cut_edges = 1;
+    std::ostringstream oss;
+    write_partition(oss, graph, partition);
+    REQUIRE(oss.str()
+        == "Part 1\n1 run a notify a\n2 run b\n"
+           "Part 2\n1 run x\n2 wait a run c\nCut edges 1\n");
+}
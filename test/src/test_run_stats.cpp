@@ -0,0 +1,76 @@
+#include <catch.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <run_stats.h>
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+TEST_CASE("phases are measured and accumulated", "[run_stats]")
+{
+    size_t allocations = 0;
+    run_stats stats([&] { return allocations; });
+    std::vector<std::string> reported;
+    stats.on_phase([&](std::string_view phase, auto time) {
+        REQUIRE(time.count() >= 0);
+        reported.emplace_back(phase);
+    });
+
+    REQUIRE(stats.measure("parse", [&] {
+        allocations += 3;
+        return 42;
+    }) == 42);
+    stats.measure("schedule", [&] { ++allocations; });
+    stats.measure("schedule", [&] { ++allocations; });
+
+    REQUIRE(reported == std::vector<std::string>{ "parse", "schedule",
+                            "schedule" });
+    const auto& phases = stats.phases();
+    REQUIRE(phases.size() == 2);
+    REQUIRE(phases[0].name == "parse");
+    REQUIRE(phases[0].allocations == 3);
+    REQUIRE(phases[0].count == 1);
+    REQUIRE(phases[1].name == "schedule");
+    REQUIRE(phases[1].allocations == 2);
+    REQUIRE(phases[1].count == 2);
+    REQUIRE(stats.allocations() == 5);
+}
+
+TEST_CASE("phase is recorded when it throws", "[run_stats]")
+{
+    run_stats stats;
+    REQUIRE_THROWS_AS(stats.measure("parse",
+                          [] { throw std::runtime_error("parse error"); }),
+        std::runtime_error);
+    REQUIRE(stats.phases().size() == 1);
+    REQUIRE(stats.phases()[0].count == 1);
+    REQUIRE(stats.allocations() == 0);
+}
+
+TEST_CASE("stats are reported as json", "[run_stats]")
+{
+    run_stats stats;
+    stats.set_graph_size(10, 11);
+    stats.add_level(2);
+    stats.add_level(3);
+    stats.add_level(1);
+    stats.measure("parse", [] {});
+    REQUIRE(stats.num_levels() == 3);
+    REQUIRE(stats.max_level_width() == 3);
+
+    std::ostringstream oss;
+    stats.write_json(oss);
+    const auto json = oss.str();
+    REQUIRE(json.find("{\"phases\":[{\"name\":\"parse\",\"ms\":") == 0);
+    REQUIRE(json.find(",\"allocations\":0}],\"vertices\":10,\"edges\":11,"
+                      "\"levels\":3,\"max_level_width\":3,\"allocations\":0,"
+                      "\"peak_rss_kb\":")
+        != std::string::npos);
+    REQUIRE(json.back() == '\n');
+}
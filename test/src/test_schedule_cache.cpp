@@ -0,0 +1,124 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <schedule_cache.h>
+
+#include "temp_file.h"
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+namespace {
+
+size_t count_files(const std::string& dir)
+{
+    size_t res = 0;
+    for (const auto& e : std::filesystem::directory_iterator(dir)) {
+        res += e.is_regular_file() ? 1 : 0;
+    }
+    return res;
+}
+
+} // namespace
+
+TEST_CASE("cache entries are keyed by input and variant", "[schedule_cache]")
+{
+    test_utils::temp_dir dir;
+    const schedule_cache cache(dir.path + "/cache");
+    REQUIRE(std::filesystem::is_directory(cache.dir()));
+    const auto entry = cache.entry_path("digraph G {}", ".csv");
+    REQUIRE(entry.parent_path() == cache.dir());
+    REQUIRE(entry.extension() == ".csv");
+    REQUIRE(entry == cache.entry_path("digraph G {}", ".csv"));
+    REQUIRE(entry != cache.entry_path("digraph G {}", ".json"));
+    REQUIRE(entry != cache.entry_path("digraph H {}", ".csv"));
+    REQUIRE(entry.filename().string().rfind(
+                std::string(schedule_cache::format_version) + '-', 0)
+        == 0);
+}
+
+TEST_CASE("stored entry is found", "[schedule_cache]")
+{
+    test_utils::temp_dir dir;
+    const schedule_cache cache(dir.path);
+    const auto entry = cache.entry_path("input", ".txt");
+    REQUIRE(!schedule_cache::find(entry, "input"));
+    const auto stored = schedule_cache::store(
+        entry, "input", [](std::ostream& os) { os << "schedule"; });
+    REQUIRE(stored.schedule() == "schedule");
+    const auto cached = schedule_cache::find(entry, "input");
+    REQUIRE(cached);
+    REQUIRE(cached->schedule() == "schedule");
+    REQUIRE(count_files(dir.path) == 1);
+}
+
+TEST_CASE("entry of another text is not found", "[schedule_cache]")
+{
+    test_utils::temp_dir dir;
+    const schedule_cache cache(dir.path);
+    // as if "other" had the hash and the size of "input"
+    const auto entry = cache.entry_path("input", ".txt");
+    schedule_cache::store(
+        entry, "other", [](std::ostream& os) { os << "schedule"; });
+    REQUIRE(schedule_cache::find(entry, "other"));
+    REQUIRE(!schedule_cache::find(entry, "input"));
+    REQUIRE(!schedule_cache::find(entry, "inputs"));
+}
+
+TEST_CASE("stored entry outlives its file", "[schedule_cache]")
+{
+    test_utils::temp_dir dir;
+    const schedule_cache cache(dir.path);
+    const auto entry = cache.entry_path("input", ".txt");
+    const auto stored = schedule_cache::store(
+        entry, "input", [](std::ostream& os) { os << "schedule"; });
+    std::filesystem::remove(entry);
+    REQUIRE(stored.schedule() == "schedule");
+}
+
+TEST_CASE("failed store leaves no entry", "[schedule_cache]")
+{
+    test_utils::temp_dir dir;
+    const schedule_cache cache(dir.path);
+    const auto entry = cache.entry_path("input", ".txt");
+    REQUIRE_THROWS_AS(schedule_cache::store(entry, "input",
+                          [](std::ostream& os) {
+                              os << "partial";
+                              throw std::runtime_error("cycle");
+                          }),
+        std::runtime_error);
+    REQUIRE(!schedule_cache::find(entry, "input"));
+    REQUIRE(count_files(dir.path) == 0);
+}
+
+TEST_CASE("entry is stored concurrently", "[schedule_cache]")
+{
+    test_utils::temp_dir dir;
+    const schedule_cache cache(dir.path);
+    const auto entry = cache.entry_path("input", ".txt");
+    const std::string content(100000, 'x');
+    std::vector<std::thread> writers;
+    std::vector<int> complete(8);
+    for (size_t i = 0; i < complete.size(); ++i) {
+        writers.emplace_back([&, i] {
+            schedule_cache::store(
+                entry, "input", [&](std::ostream& os) { os << content; });
+            // a reader never sees a partial entry
+            const auto cached = schedule_cache::find(entry, "input");
+            complete[i] = cached && cached->schedule() == content;
+        });
+    }
+    for (auto& w : writers) {
+        w.join();
+    }
+    REQUIRE(std::count(complete.begin(), complete.end(), 1) == 8);
+    REQUIRE(count_files(dir.path) == 1);
+}
@@ -0,0 +1,117 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <job_graph.h>
+#include <schedule_cursor.h>
+#include <schedule_range.h>
+
+#include "test_graphs.h"
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+using test_utils::create_reference_graph;
+
+namespace {
+
+template <typename T>
+std::vector<std::vector<T>> sorted(std::vector<std::vector<T>> schedule)
+{
+    for (auto& level : schedule) {
+        std::sort(level.begin(), level.end());
+    }
+    return schedule;
+}
+
+} // namespace
+
+TEST_CASE("cursor schedules without modifying the graph", "[cursor]")
+{
+    const auto graph = create_reference_graph();
+    const auto first = schedule_cursor(graph).get_full_schedule();
+    const auto second = schedule_cursor(graph).get_full_schedule();
+    REQUIRE(first == second);
+    REQUIRE(graph.num_vertices() == 10);
+    REQUIRE(graph.state_of("a") == vertex_state::ready);
+    auto scheduled = create_reference_graph();
+    REQUIRE(sorted(first) == sorted(scheduled.get_full_schedule()));
+}
+
+TEST_CASE("cursor starts at the scheduling state of the graph", "[cursor]")
+{
+    auto graph = create_reference_graph();
+    graph.next_schedule();
+    schedule_cursor cursor(graph);
+    REQUIRE(cursor.num_vertices() == 8);
+    REQUIRE(sorted(cursor.get_full_schedule())
+        == sorted(graph.get_full_schedule()));
+    REQUIRE(cursor.is_done());
+    REQUIRE_THROWS(cursor.next_schedule());
+    REQUIRE(schedule_cursor(graph).is_done());
+}
+
+TEST_CASE("cursors can run concurrently on a graph", "[cursor]")
+{
+    const auto graph = create_reference_graph();
+    const auto expected = schedule_cursor(graph).get_full_schedule();
+    std::vector<std::vector<std::vector<std::string>>> results(4);
+    std::vector<std::thread> threads;
+    for (auto& res : results) {
+        threads.emplace_back(
+            [&] { res = schedule_cursor(graph).get_full_schedule(); });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (const auto& res : results) {
+        REQUIRE(res == expected);
+    }
+}
+
+TEST_CASE("cursor levels can be streamed", "[cursor]")
+{
+    const auto graph = create_reference_graph();
+    schedule_cursor cursor(graph);
+    size_t count = 0;
+    for (const auto& level : schedule_levels(cursor)) {
+        count += level.size();
+    }
+    REQUIRE(count == 10);
+    REQUIRE(graph.num_vertices() == 10);
+}
+
+TEST_CASE("cursor reports cycles like the graph", "[cursor]")
+{
+    const auto graph = make_graph({ std::make_pair("a"s, "b"s),
+        std::make_pair("b"s, "c"s), std::make_pair("c"s, "b"s) });
+    schedule_cursor cursor(graph);
+    REQUIRE_THROWS(cursor.next_schedule());
+}
+
+TEST_CASE("copies of a graph share the structure until modified",
+    "[cursor]")
+{
+    auto graph = create_reference_graph();
+    auto copy = graph;
+    REQUIRE(&copy.storage() == &graph.storage());
+    copy.next_schedule();
+    REQUIRE(&copy.storage() == &graph.storage());
+    REQUIRE(graph.num_vertices() == 10);
+    REQUIRE(copy.num_vertices() == 8);
+    // what if j had to wait for b
+    copy.add_edge("b"s, "j"s);
+    REQUIRE(&copy.storage() != &graph.storage());
+    REQUIRE(graph.num_edges() == 11);
+    REQUIRE(copy.num_edges() == 12);
+    REQUIRE(!graph.remove_edge("x", "j"));
+    REQUIRE(schedule_cursor(graph).get_full_schedule().size() == 5);
+    REQUIRE(copy.get_full_schedule().size() == 4);
+    graph = copy;
+    REQUIRE(graph.is_done());
+}
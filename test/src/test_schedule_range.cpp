@@ -0,0 +1,94 @@
+#include <catch.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <job_graph.h>
+#include <schedule_range.h>
+
+#include "test_graphs.h"
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+using test_utils::create_reference_graph;
+
+TEST_CASE("streamed levels are the levels of the full schedule",
+    "[schedule_range]")
+{
+    auto reference = create_reference_graph();
+    const auto expected = reference.get_full_schedule();
+    auto graph = create_reference_graph();
+    std::vector<std::vector<std::string>> streamed;
+    for (const auto& level : schedule_levels(graph)) {
+        REQUIRE(level.depth() == streamed.size() + 1);
+        streamed.emplace_back(level.begin(), level.end());
+        REQUIRE(streamed.back().size() == level.size());
+    }
+    REQUIRE(streamed == expected);
+    REQUIRE(graph.is_done());
+}
+
+TEST_CASE("levels are computed lazily", "[schedule_range]")
+{
+    auto graph = create_reference_graph();
+    auto range = schedule_levels(graph);
+    REQUIRE(graph.num_vertices() == 10);
+    auto it = range.begin();
+    REQUIRE(it != range.end());
+    REQUIRE(graph.num_vertices() == 8);
+    REQUIRE(graph.state_of("a") == vertex_state::scheduled);
+    REQUIRE(graph.state_of("g") == vertex_state::ready);
+    ++it;
+    REQUIRE(it->depth() == 2);
+    REQUIRE(graph.num_vertices() == 5);
+    REQUIRE(graph.state_of("f") == vertex_state::pending);
+}
+
+TEST_CASE("levels refer to the payloads kept in the graph", "[schedule_range]")
+{
+    auto graph = create_reference_graph();
+    for (const auto& level : schedule_levels(graph)) {
+        auto it = level.begin();
+        for (auto id : level.ids()) {
+            REQUIRE(&*it++ == &graph.vertex_at(id));
+        }
+    }
+}
+
+TEST_CASE("schedule of a done graph is empty", "[schedule_range]")
+{
+    auto graph = create_reference_graph();
+    graph.get_full_schedule();
+    auto range = schedule_levels(graph);
+    REQUIRE(range.begin() == range.end());
+}
+
+TEST_CASE("cycles are reported while streaming", "[schedule_range]")
+{
+    auto graph = make_graph({ std::make_pair("a"s, "b"s),
+        std::make_pair("b"s, "c"s), std::make_pair("c"s, "d"s),
+        std::make_pair("d"s, "c"s) });
+    auto range = schedule_levels(graph);
+    auto it = range.begin();
+    REQUIRE(it->depth() == 1);
+    REQUIRE_THROWS(++it);
+}
+
+TEST_CASE("cycles are found before streaming", "[schedule_range]")
+{
+    auto graph = make_graph({ std::make_pair("a"s, "b"s),
+        std::make_pair("b"s, "c"s), std::make_pair("c"s, "d"s),
+        std::make_pair("d"s, "c"s) });
+    REQUIRE_THROWS(check_acyclic(graph));
+    // the graph is not scheduled by the check
+    auto range = schedule_levels(graph);
+    REQUIRE(range.begin()->depth() == 1);
+
+    auto reference = create_reference_graph();
+    REQUIRE_NOTHROW(check_acyclic(reference));
+    REQUIRE(reference.num_vertices() == 10);
+    REQUIRE(reference.state_of("a") == vertex_state::ready);
+}
@@ -0,0 +1,309 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <schedule_service.h>
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+namespace {
+
+// bytes requested from operator new and not freed yet, by the whole test
+// binary
+std::atomic<size_t> live_bytes{ 0 };
+
+// the requested size is kept in front of the memory returned
+void* allocate(size_t size, size_t alignment)
+{
+    const auto header = std::max(alignment, alignof(std::max_align_t));
+    void* p = std::aligned_alloc(
+        header, (header + size + header - 1) / header * header);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    live_bytes += size;
+    auto* res = static_cast<char*>(p) + header;
+    reinterpret_cast<size_t*>(res)[-1] = size;
+    return res;
+}
+
+void deallocate(void* p, size_t alignment) noexcept
+{
+    if (!p) {
+        return;
+    }
+    const auto header = std::max(alignment, alignof(std::max_align_t));
+    live_bytes -= static_cast<size_t*>(p)[-1];
+    std::free(static_cast<char*>(p) - header);
+}
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept
+{
+    deallocate(p, alignof(std::max_align_t));
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    deallocate(p, alignof(std::max_align_t));
+}
+
+void operator delete(void* p, std::align_val_t alignment) noexcept
+{
+    deallocate(p, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept
+{
+    deallocate(p, static_cast<size_t>(alignment));
+}
+
+namespace {
+
+const auto reference_dot = "digraph G {\n"
+                           "    \"a\" -> \"g\";\n"
+                           "    \"b\" -> \"c\";\n"
+                           "    \"b\" -> \"d\";\n"
+                           "    \"g\" -> \"h\";\n"
+                           "    \"g\" -> \"i\";\n"
+                           "    \"c\" -> \"e\";\n"
+                           "    \"d\" -> \"e\";\n"
+                           "    \"h\" -> \"j\";\n"
+                           "    \"i\" -> \"j\";\n"
+                           "    \"e\" -> \"f\";\n"
+                           "    \"j\" -> \"f\";\n"
+                           "}\n"s;
+
+const auto reference_csv = "depth,vertex\n1,a\n1,b\n2,g\n2,c\n2,d\n3,h\n"
+                           "3,i\n3,e\n4,j\n5,f\n"s;
+
+std::string request(schedule_service& service, std::string_view line,
+    std::string_view body = {})
+{
+    const auto req = schedule_service::parse_request(line);
+    REQUIRE(req.body_size == body.size());
+    return service.respond(req, body);
+}
+
+// graph of edges from every label to x
+std::string dot_of(std::initializer_list<std::string_view> labels)
+{
+    std::string res = "digraph G {\n";
+    for (auto label : labels) {
+        res += "\"" + std::string(label) + "\" -> \"x\";\n";
+    }
+    return res + "}\n";
+}
+
+// size charged by a service for the graph of dot_of(labels)
+size_t charged_size(std::initializer_list<std::string_view> labels)
+{
+    schedule_service service;
+    service.add(dot_of(labels));
+    return service.size_in_bytes();
+}
+
+std::string with_size(const std::string& payload)
+{
+    return "OK " + std::to_string(payload.size()) + '\n' + payload;
+}
+
+} // namespace
+
+TEST_CASE("content hash is stable", "[schedule_service]")
+{
+    // persisted keys depend on these values
+    REQUIRE(content_hash("") == 0);
+    REQUIRE(content_hash("a") == 0xa716fb202fc4d34bull);
+    REQUIRE(content_hash("digraph G {\n}\n") == 0x57096175bed0dc7full);
+    REQUIRE(content_hash("digraph G {\n}\n") != content_hash("digraph G {\n}"));
+    REQUIRE(to_hex(0x0123456789abcdefull) == "0123456789abcdef");
+    REQUIRE(parse_hex("0123456789abcdef") == 0x0123456789abcdefull);
+    REQUIRE(!parse_hex("0123456789abcdeg"));
+    REQUIRE(!parse_hex("123"));
+}
+
+TEST_CASE("requests are parsed", "[schedule_service]")
+{
+    using command = service_request::command;
+    auto req = schedule_service::parse_request("GRAPH 12");
+    REQUIRE(req.cmd == command::graph);
+    REQUIRE(req.body_size == 12);
+    req = schedule_service::parse_request("SCHEDULE 00000000000000ff json\r");
+    REQUIRE(req.cmd == command::schedule);
+    REQUIRE(req.hash == 0xff);
+    REQUIRE(req.format == schedule_format::json);
+    req = schedule_service::parse_request("RUN 3");
+    REQUIRE(req.cmd == command::run);
+    REQUIRE(req.format == schedule_format::table);
+
+    REQUIRE_THROWS_AS(
+        schedule_service::parse_request("PUT 1"), std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        schedule_service::parse_request("GRAPH x"), std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        schedule_service::parse_request("LOOKUP 12"), std::invalid_argument);
+    REQUIRE_THROWS_AS(schedule_service::parse_request("RUN 1 xml"),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(schedule_service::parse_request("RUN 1 csv extra"),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(schedule_service::parse_request("GRAPH 99999999999"),
+        std::invalid_argument);
+    REQUIRE(schedule_service::parse_request("RUN 10", 10).body_size == 10);
+    REQUIRE_THROWS_AS(
+        schedule_service::parse_request("RUN 11", 10), std::invalid_argument);
+}
+
+TEST_CASE("graphs are parsed once and scheduled from the cache",
+    "[schedule_service]")
+{
+    schedule_service service;
+    const auto hash = to_hex(content_hash(reference_dot));
+    const auto graph_line = "GRAPH " + std::to_string(reference_dot.size());
+    REQUIRE(request(service, graph_line, reference_dot)
+        == "OK " + hash + '\n');
+    REQUIRE(request(service, "LOOKUP " + hash) == "OK 10 11\n");
+    REQUIRE(request(service, "SCHEDULE " + hash + " csv")
+        == with_size(reference_csv));
+    // scheduling doesn't consume the cached graph
+    REQUIRE(request(service, "SCHEDULE " + hash + " csv")
+        == with_size(reference_csv));
+    const auto run_line
+        = "RUN " + std::to_string(reference_dot.size()) + " csv";
+    REQUIRE(request(service, run_line, reference_dot)
+        == with_size(reference_csv));
+    REQUIRE(service.size() == 1);
+    REQUIRE(service.num_parsed() == 1);
+}
+
+TEST_CASE("errors are answered", "[schedule_service]")
+{
+    schedule_service service;
+    REQUIRE(request(service, "SCHEDULE 0000000000000001")
+        == "ERR unknown graph 0000000000000001\n");
+    const auto invalid = "digraph G {\n\"a\" -> b;\n}\n"sv;
+    REQUIRE(request(service, "GRAPH " + std::to_string(invalid.size()),
+                invalid)
+        == "ERR dotfile error on line 2:\"a\" -> b;\n");
+    const auto cycle = "digraph G {\n\"a\" -> \"b\";\n\"b\" -> \"c\";\n"
+                       "\"c\" -> \"b\";\n}\n"sv;
+    REQUIRE(request(service, "RUN " + std::to_string(cycle.size()), cycle)
+        == "ERR no entry point in graph\n");
+    REQUIRE(service.num_parsed() == 1);
+}
+
+TEST_CASE("least recently used graph is dropped", "[schedule_service]")
+{
+    const auto size = charged_size({ "a" });
+    schedule_service service(2 * size);
+    const auto a = service.add(dot_of({ "a" })).first;
+    const auto b = service.add(dot_of({ "b" })).first;
+    REQUIRE(service.find(a));
+    const auto c = service.add(dot_of({ "c" })).first;
+    REQUIRE(service.size() == 2);
+    REQUIRE(service.size_in_bytes() == 2 * size);
+    REQUIRE(service.find(a));
+    REQUIRE(!service.find(b));
+    REQUIRE(service.find(c));
+}
+
+TEST_CASE("cached graphs are charged at least their memory",
+    "[schedule_service]")
+{
+    std::string labels;
+    for (int i = 0; i < 500; ++i) {
+        labels += "\"" + std::to_string(i) + "\" -> \"" + std::to_string(i / 2)
+            + "_\";\n";
+    }
+    const auto text = "digraph G {\n" + labels + "}\n";
+    const auto before = live_bytes.load();
+    auto graph = std::make_unique<cached_graph>(std::string(text));
+    const auto footprint = live_bytes.load() - before;
+    REQUIRE(graph->get().storage().size() == 750);
+    REQUIRE(graph->size_in_bytes() >= footprint);
+    // capacities are counted, not estimated
+    REQUIRE(graph->size_in_bytes() <= footprint + footprint / 4);
+}
+
+TEST_CASE("graphs are dropped until the cache size fits",
+    "[schedule_service]")
+{
+    const auto small = charged_size({ "a" });
+    const auto large = charged_size({ "d", "e" });
+    // the large graph takes the room of two small ones
+    REQUIRE(large > small);
+    REQUIRE(large <= 2 * small);
+    schedule_service service(3 * small);
+    const auto a = service.add(dot_of({ "a" })).first;
+    const auto b = service.add(dot_of({ "b" })).first;
+    const auto c = service.add(dot_of({ "c" })).first;
+    REQUIRE(service.size() == 3);
+    REQUIRE(service.find(a));
+    const auto d = service.add(dot_of({ "d", "e" })).first;
+    REQUIRE(service.size() == 2);
+    REQUIRE(service.size_in_bytes() == small + large);
+    REQUIRE(service.find(a));
+    REQUIRE(!service.find(b));
+    REQUIRE(!service.find(c));
+    REQUIRE(service.find(d));
+}
+
+TEST_CASE("graphs larger than the cache are answered but not kept",
+    "[schedule_service]")
+{
+    schedule_service service(reference_dot.size());
+    const auto run_line
+        = "RUN " + std::to_string(reference_dot.size()) + " csv";
+    REQUIRE(request(service, run_line, reference_dot)
+        == with_size(reference_csv));
+    REQUIRE(service.size() == 0);
+    REQUIRE(service.size_in_bytes() == 0);
+}
+
+TEST_CASE("service answers concurrent requests", "[schedule_service]")
+{
+    schedule_service service;
+    const auto run_line
+        = "RUN " + std::to_string(reference_dot.size()) + " csv";
+    const auto req = schedule_service::parse_request(run_line);
+    std::vector<std::thread> clients;
+    std::vector<int> ok(8);
+    for (size_t i = 0; i < ok.size(); ++i) {
+        clients.emplace_back([&, i] {
+            for (int j = 0; j < 100; ++j) {
+                ok[i] += service.respond(req, reference_dot)
+                    == with_size(reference_csv);
+            }
+        });
+    }
+    for (auto& c : clients) {
+        c.join();
+    }
+    for (auto n : ok) {
+        REQUIRE(n == 100);
+    }
+    REQUIRE(service.size() == 1);
+}
@@ -0,0 +1,147 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <job_graph.h>
+#include <schedule_range.h>
+#include <schedule_writer.h>
+
+#include "test_graphs.h"
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+using test_utils::create_reference_graph;
+
+namespace {
+
+std::string write(schedule_format format, size_t buffer_size = 4096)
+{
+    auto graph = create_reference_graph();
+    std::ostringstream oss;
+    schedule_writer writer(oss, format, buffer_size);
+    for (const auto& level : schedule_levels(graph)) {
+        writer.write_level(level);
+    }
+    writer.finish();
+    return oss.str();
+}
+
+template <typename T>
+T read_raw(std::string_view& data)
+{
+    REQUIRE(data.size() >= sizeof(T));
+    T res;
+    std::memcpy(&res, data.data(), sizeof(T));
+    data.remove_prefix(sizeof(T));
+    return res;
+}
+
+} // namespace
+
+TEST_CASE("schedule is written as table", "[schedule_writer]")
+{
+    const auto expected
+        = "Depth                     Independent vertices     \n"
+          "==================================================\n"
+          "1                        a,b,\n"
+          "2                        g,c,d,\n"
+          "3                        h,i,e,\n"
+          "4                        j,\n"
+          "5                        f,\n"s;
+    REQUIRE(write(schedule_format::table) == expected);
+    // smaller buffers only change the number of writes
+    REQUIRE(write(schedule_format::table, 1) == expected);
+    REQUIRE(write(schedule_format::table, 7) == expected);
+}
+
+TEST_CASE("schedule is written as csv and json", "[schedule_writer]")
+{
+    REQUIRE(write(schedule_format::csv)
+        == "depth,vertex\n1,a\n1,b\n2,g\n2,c\n2,d\n3,h\n3,i\n3,e\n4,j\n5,f\n");
+    REQUIRE(write(schedule_format::json)
+        == "{\"levels\":[\n[\"a\",\"b\"],\n[\"g\",\"c\",\"d\"],\n"
+           "[\"h\",\"i\",\"e\"],\n[\"j\"],\n[\"f\"]\n]}\n");
+
+    std::ostringstream empty;
+    write_schedule(
+        empty, std::vector<std::vector<int>>{}, schedule_format::json);
+    REQUIRE(empty.str() == "{\"levels\":[]}\n");
+}
+
+TEST_CASE("labels are escaped", "[schedule_writer]")
+{
+    const std::vector<std::vector<std::string>> schedule{
+        { "plain", "a,b", "say \"hi\"" }, { "back\\slash\nnext\x01" }
+    };
+    std::ostringstream csv;
+    write_schedule(csv, schedule, schedule_format::csv);
+    REQUIRE(csv.str()
+        == "depth,vertex\n1,plain\n1,\"a,b\"\n1,\"say \"\"hi\"\"\"\n"
+           "2,\"back\\slash\nnext\x01\"\n");
+
+    std::ostringstream json;
+    write_schedule(json, schedule, schedule_format::json);
+    REQUIRE(json.str()
+        == "{\"levels\":[\n[\"plain\",\"a,b\",\"say \\\"hi\\\"\"],\n"
+           "[\"back\\\\slash\\nnext\\u0001\"]\n]}\n");
+}
+
+TEST_CASE("integral vertices are written as labels", "[schedule_writer]")
+{
+    std::ostringstream oss;
+    write_schedule(oss,
+        std::vector<std::vector<int>>{ { 1, -2 }, { 30 } },
+        schedule_format::csv);
+    REQUIRE(oss.str() == "depth,vertex\n1,1\n1,-2\n2,30\n");
+}
+
+TEST_CASE("schedule is written in binary format", "[schedule_writer]")
+{
+    const auto out = write(schedule_format::binary, 16);
+    std::string_view data(out);
+    const auto header = read_raw<binary_schedule_format::header>(data);
+    REQUIRE(std::memcmp(header.magic, binary_schedule_format::magic,
+                sizeof(header.magic))
+        == 0);
+    REQUIRE(header.version == binary_schedule_format::version);
+    REQUIRE(header.byte_order_mark == binary_schedule_format::byte_order_mark);
+
+    std::vector<std::vector<std::string>> schedule;
+    while (const auto size = read_raw<std::uint32_t>(data)) {
+        auto& level = schedule.emplace_back();
+        for (std::uint32_t i = 0; i < size; ++i) {
+            const auto label_size = read_raw<std::uint32_t>(data);
+            REQUIRE(data.size() >= label_size);
+            level.emplace_back(data.substr(0, label_size));
+            data.remove_prefix(label_size);
+        }
+    }
+    REQUIRE(data.empty());
+    REQUIRE(schedule == create_reference_graph().get_full_schedule());
+}
+
+TEST_CASE("levels written before an error are kept", "[schedule_writer]")
+{
+    auto graph = make_graph({ std::make_pair("a"s, "b"s),
+        std::make_pair("b"s, "c"s), std::make_pair("d"s, "c"s),
+        std::make_pair("c"s, "d"s) });
+    std::ostringstream oss;
+    REQUIRE_THROWS_AS(
+        write_schedule(oss, schedule_levels(graph), schedule_format::csv),
+        std::runtime_error);
+    REQUIRE(oss.str() == "depth,vertex\n1,a\n");
+}
+
+TEST_CASE("invalid schedule format is rejected", "[schedule_writer]")
+{
+    REQUIRE(parse_schedule_format("json") == schedule_format::json);
+    REQUIRE_THROWS_AS(parse_schedule_format("xml"), std::invalid_argument);
+}
@@ -0,0 +1,88 @@
+#include <catch.hpp>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <job_graph.h>
+#include <static_graph.h>
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+namespace {
+
+constexpr auto create_reference_graph()
+{
+    return make_static_graph({ std::make_pair("a"sv, "g"sv),
+        std::make_pair("b"sv, "c"sv), std::make_pair("b"sv, "d"sv),
+        std::make_pair("g"sv, "h"sv), std::make_pair("g"sv, "i"sv),
+        std::make_pair("c"sv, "e"sv), std::make_pair("d"sv, "e"sv),
+        std::make_pair("h"sv, "j"sv), std::make_pair("i"sv, "j"sv),
+        std::make_pair("e"sv, "f"sv), std::make_pair("j"sv, "f"sv) });
+}
+
+constexpr auto reference_schedule = create_reference_graph().schedule();
+
+static_assert(reference_schedule.num_levels() == 5);
+static_assert(reference_schedule.num_vertices() == 10);
+static_assert(reference_schedule[0].size() == 2);
+static_assert(reference_schedule[0][0] == "a"sv);
+static_assert(reference_schedule[0][1] == "b"sv);
+static_assert(reference_schedule[4].size() == 1);
+static_assert(reference_schedule[4][0] == "f"sv);
+
+} // namespace
+
+TEST_CASE("static graph is scheduled at compile time", "[static_graph]")
+{
+    constexpr auto graph = create_reference_graph();
+    static_assert(graph.num_vertices() == 10);
+    static_assert(graph.num_edges() == 11);
+    static_assert(*graph.id_of("g"sv) == 1);
+    static_assert(!graph.id_of("x"sv));
+    static_assert(graph.in_degree(*graph.id_of("f"sv)) == 2);
+
+    const std::vector<std::vector<std::string_view>> expected{ { "a", "b" },
+        { "g", "c", "d" }, { "h", "i", "e" }, { "j" }, { "f" } };
+    REQUIRE(reference_schedule.get_full_schedule() == expected);
+}
+
+TEST_CASE("static schedule matches the schedule of graph", "[static_graph]")
+{
+    constexpr std::pair<int, int> edges[] = { { 1, 2 }, { 1, 3 }, { 4, 3 },
+        { 2, 5 }, { 3, 5 }, { 5, 6 }, { 4, 6 }, { 7, 6 } };
+    constexpr auto schedule = make_static_graph(edges).schedule();
+    static_assert(schedule.num_levels() == 4);
+
+    auto graph = make_graph(std::begin(edges), std::end(edges));
+    REQUIRE(schedule.get_full_schedule() == graph.get_full_schedule());
+}
+
+TEST_CASE("static graph with explicit capacity", "[static_graph]")
+{
+    constexpr static_graph<unsigned, 4, 8> graph({ std::make_pair(1u, 2u),
+        std::make_pair(2u, 3u), std::make_pair(1u, 3u) });
+    constexpr auto schedule = graph.schedule();
+    static_assert(schedule.num_levels() == 3);
+    static_assert(schedule[1][0] == 2u);
+    const auto out = graph.out_edges(0);
+    REQUIRE(std::vector<vertex_id>(out.begin(), out.end())
+        == std::vector<vertex_id>{ 1, 2 });
+
+    // in a constant expression these are compile errors
+    REQUIRE_THROWS_AS(
+        (static_graph<unsigned, 2, 8>({ std::make_pair(1u, 2u),
+            std::make_pair(2u, 3u) })),
+        std::runtime_error);
+}
+
+TEST_CASE("static graph with cycle can't be scheduled", "[static_graph]")
+{
+    // constexpr auto schedule = graph.schedule(); doesn't compile
+    const auto graph = make_static_graph({ std::make_pair("a"sv, "b"sv),
+        std::make_pair("b"sv, "c"sv), std::make_pair("c"sv, "b"sv) });
+    REQUIRE_THROWS_AS(graph.schedule(), std::runtime_error);
+}
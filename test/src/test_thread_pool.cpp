@@ -0,0 +1,48 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include <thread_pool.h>
+
+using namespace job_sheduler;
+
+TEST_CASE("thread pool executes all submitted tasks", "[thread pool]")
+{
+    std::atomic<int> counter{ 0 };
+    {
+        thread_pool pool(4);
+        REQUIRE(pool.size() == 4);
+        for (int i = 0; i < 1000; ++i) {
+            pool.submit([&counter] { ++counter; });
+        }
+    }
+    REQUIRE(counter == 1000);
+}
+
+TEST_CASE("thread pool returns results through futures", "[thread pool]")
+{
+    thread_pool pool(2);
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; ++i) {
+        results.push_back(pool.submit([i] { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(results[i].get() == i * i);
+    }
+}
+
+TEST_CASE("thread pool propagates exceptions", "[thread pool]")
+{
+    thread_pool pool(1);
+    auto res = pool.submit([]() -> int { throw std::runtime_error("x"); });
+    REQUIRE_THROWS_AS(res.get(), std::runtime_error);
+}
+
+TEST_CASE("default thread pool has at least one thread", "[thread pool]")
+{
+    thread_pool pool;
+    REQUIRE(pool.size() >= 1);
+}
@@ -0,0 +1,283 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <schedule_service.h>
+#include <unix_server.h>
+
+#include "temp_file.h"
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+namespace {
+
+const auto dot = "digraph G {\n    \"a\" -> \"b\";\n}\n"s;
+
+const auto csv = "depth,vertex\n1,a\n2,b\n"s;
+
+std::string run_request(cli::connection& client, const std::string& body)
+{
+    client.write("RUN " + std::to_string(body.size()) + " csv\n" + body);
+    std::string line;
+    std::string payload;
+    if (!client.read_line(line) || line.rfind("OK ", 0) != 0) {
+        return line;
+    }
+    client.read(payload, std::stoul(line.substr(3)));
+    return line + '\n' + payload;
+}
+
+// both ends of a connected socket pair
+std::pair<cli::unique_fd, cli::unique_fd> socket_pair()
+{
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        throw std::runtime_error("socketpair");
+    }
+    return { cli::unique_fd(fds[0]), cli::unique_fd(fds[1]) };
+}
+
+// the scheduler binary given by SCHEDULER_BINARY run with the arguments,
+// terminated on destruction
+class process {
+public:
+    explicit process(std::initializer_list<std::string> args)
+    {
+        const char* binary = std::getenv("SCHEDULER_BINARY");
+        if (!binary) {
+            throw std::runtime_error("SCHEDULER_BINARY is not set");
+        }
+        std::vector<std::string> argv_storage{ binary };
+        argv_storage.insert(argv_storage.end(), args.begin(), args.end());
+        std::vector<char*> argv;
+        for (auto& arg : argv_storage) {
+            argv.push_back(arg.data());
+        }
+        argv.push_back(nullptr);
+        m_pid = ::fork();
+        if (m_pid == 0) {
+            const int null = ::open("/dev/null", O_WRONLY);
+            ::dup2(null, STDOUT_FILENO);
+            ::dup2(null, STDERR_FILENO);
+            ::execv(binary, argv.data());
+            ::_exit(127);
+        }
+    }
+
+    process(const process&) = delete;
+
+    process& operator=(const process&) = delete;
+
+    ~process()
+    {
+        if (m_status < 0) {
+            ::kill(m_pid, SIGTERM);
+            wait();
+        }
+    }
+
+    // exit status of the process, waits for it to exit
+    int wait()
+    {
+        int status = 0;
+        ::waitpid(m_pid, &status, 0);
+        m_status = WIFEXITED(status) ? WEXITSTATUS(status) : 256;
+        return m_status;
+    }
+
+private:
+    pid_t m_pid{};
+    int m_status = -1;
+};
+
+// connects to the socket at path, waits up to 10 s for the server to
+// listen
+cli::connection connect_to(const std::string& path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), address.sun_path);
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        cli::unique_fd fd(::socket(AF_UNIX, SOCK_STREAM, 0));
+        if (::connect(fd.get(), reinterpret_cast<const sockaddr*>(&address),
+                sizeof(address))
+            == 0) {
+            return cli::connection(std::move(fd));
+        }
+        std::this_thread::sleep_for(10ms);
+    }
+    throw std::runtime_error("no server at " + path);
+}
+
+} // namespace
+
+TEST_CASE("long request lines are rejected", "[unix_server]")
+{
+    auto[client, server] = socket_pair();
+    cli::connection connection(std::move(server));
+    cli::connection(std::move(client))
+        .write(std::string(cli::connection::max_line_size + 1, 'x'));
+    std::string line;
+    REQUIRE_THROWS_AS(connection.read_line(line), std::length_error);
+}
+
+TEST_CASE("declared body sizes are not allocated up front", "[unix_server]")
+{
+    auto[client, server] = socket_pair();
+    cli::connection connection(std::move(server));
+    cli::connection(std::move(client)).write("GRAPH 1073741824\nabc");
+    std::string line;
+    std::string body;
+    REQUIRE(connection.read_line(line));
+    REQUIRE(!connection.read(body, schedule_service::default_max_body_size));
+    REQUIRE(body == "abc");
+    REQUIRE(body.capacity() < 1024 * 1024);
+}
+
+TEST_CASE("clients are served one request after another", "[unix_server]")
+{
+    schedule_service service;
+    auto[client_fd, server_fd] = socket_pair();
+    std::thread server([&service, fd = std::move(server_fd)]() mutable {
+        cli::serve_client(service, cli::connection(std::move(fd)));
+    });
+    std::string first;
+    std::string second;
+    std::string error;
+    {
+        cli::connection client(std::move(client_fd));
+        first = run_request(client, dot);
+        second = run_request(client, dot);
+        client.write("PUT 1\n");
+        client.read_line(error);
+    }
+    server.join();
+    const auto expected = "OK " + std::to_string(csv.size()) + '\n' + csv;
+    REQUIRE(first == expected);
+    REQUIRE(second == expected);
+    REQUIRE(error == "ERR unknown request: PUT");
+    REQUIRE(service.num_parsed() == 1);
+}
+
+TEST_CASE("client threads are limited and joined", "[unix_server]")
+{
+    std::atomic<int> running{ 0 };
+    std::atomic<int> max_running{ 0 };
+    std::atomic<int> done{ 0 };
+    {
+        cli::client_threads threads(2);
+        for (int i = 0; i < 8; ++i) {
+            threads.start([&] {
+                const auto now = ++running;
+                auto max = max_running.load();
+                while (now > max
+                    && !max_running.compare_exchange_weak(max, now)) {
+                }
+                std::this_thread::sleep_for(5ms);
+                --running;
+                ++done;
+            });
+        }
+    }
+    REQUIRE(done == 8);
+    REQUIRE(max_running <= 2);
+}
+
+TEST_CASE("sockets of running servers are not replaced", "[unix_server]")
+{
+    test_utils::temp_dir dir;
+    const auto path = dir.path + "/socket";
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), address.sun_path);
+    cli::unique_fd listener(::socket(AF_UNIX, SOCK_STREAM, 0));
+    REQUIRE(::bind(listener.get(), reinterpret_cast<const sockaddr*>(&address),
+                sizeof(address))
+        == 0);
+    // bound but not listening yet, connections are refused
+    REQUIRE(cli::is_stale_socket(address));
+    REQUIRE(::listen(listener.get(), SOMAXCONN) == 0);
+    REQUIRE(!cli::is_stale_socket(address));
+    schedule_service service;
+    REQUIRE_THROWS_WITH(cli::serve(service, path), "address in use: " + path);
+    REQUIRE(std::filesystem::exists(path));
+    // a connection still reaches the listener
+    auto client = connect_to(path);
+    cli::unique_fd accepted(::accept(listener.get(), nullptr, nullptr));
+    REQUIRE(accepted.get() >= 0);
+}
+
+// the scheduler binary is started by the test_scheduler_serve ctest
+TEST_CASE("scheduler answers requests on --serve", "[.][serve]")
+{
+    test_utils::temp_dir dir;
+    const auto path = dir.path + "/socket";
+    std::string response;
+    {
+        process server({ "--serve", path });
+        auto client = connect_to(path);
+        response = run_request(client, dot);
+    }
+    REQUIRE(response == "OK " + std::to_string(csv.size()) + '\n' + csv);
+    // the socket left behind by the terminated server is replaced
+    REQUIRE(std::filesystem::exists(path));
+    process restarted({ "--serve", path });
+    auto client = connect_to(path);
+    REQUIRE(run_request(client, dot) == response);
+}
+
+TEST_CASE("--serve doesn't take over the socket of a running server",
+    "[.][serve]")
+{
+    test_utils::temp_dir dir;
+    const auto path = dir.path + "/socket";
+    process server({ "--serve", path });
+    auto client = connect_to(path);
+    process second({ "--serve", path });
+    REQUIRE(second.wait() != 0);
+    REQUIRE(run_request(client, dot)
+        == "OK " + std::to_string(csv.size()) + '\n' + csv);
+    auto other = connect_to(path);
+    REQUIRE(run_request(other, dot)
+        == "OK " + std::to_string(csv.size()) + '\n' + csv);
+}
+
+TEST_CASE("--serve rejects bodies larger than --max-body", "[.][serve]")
+{
+    test_utils::temp_dir dir;
+    const auto path = dir.path + "/socket";
+    process server({ "--serve", path, "--max-body", "8" });
+    auto client = connect_to(path);
+    REQUIRE(run_request(client, dot) == "ERR request body too large");
+}
+
+TEST_CASE("--serve keeps files that are not sockets", "[.][serve]")
+{
+    test_utils::temp_file file("keep");
+    process server({ "--serve", file.path });
+    REQUIRE(server.wait() != 0);
+    std::ifstream ifs(file.path);
+    std::string content;
+    std::getline(ifs, content);
+    REQUIRE(content == "keep");
+}
@@ -0,0 +1,85 @@
+#include <catch.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <vertex_index.h>
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+TEST_CASE("id hash table interns keys to dense ids", "[index]")
+{
+    std::vector<std::string> keys;
+    id_hash_table table;
+    const auto intern = [&](const std::string& key) {
+        auto[id, inserted] = table.insert(std::hash<std::string>{}(key),
+            [&](vertex_id other) { return keys[other] == key; });
+        if (inserted) {
+            keys.push_back(key);
+        }
+        return id;
+    };
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(intern(std::to_string(i)) == vertex_id(i));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(intern(std::to_string(i)) == vertex_id(i));
+    }
+    REQUIRE(table.size() == 1000);
+    const auto find = [&](const std::string& key) {
+        return table.find(std::hash<std::string>{}(key),
+            [&](vertex_id other) { return keys[other] == key; });
+    };
+    REQUIRE(find("512") == vertex_id(512));
+    REQUIRE(find("1000") == invalid_vertex);
+}
+
+TEST_CASE("id hash table resolves colliding hashes", "[index]")
+{
+    std::vector<int> keys{ 1, 2, 3 };
+    id_hash_table table(3);
+    for (auto k : keys) {
+        auto res
+            = table.insert(42, [&](vertex_id id) { return keys[id] == k; });
+        REQUIRE(res.second);
+    }
+    REQUIRE(table.find(42, [&](vertex_id id) { return keys[id] == 3; }) == 2);
+    REQUIRE(table.find(42, [&](vertex_id id) { return keys[id] == 4; })
+        == invalid_vertex);
+    REQUIRE(table.find(7, [](vertex_id) { return true; }) == invalid_vertex);
+}
+
+TEST_CASE("erased ids are not found and not reused", "[index]")
+{
+    // few distinct hashes, so the ids form long probe sequences
+    std::vector<int> keys;
+    id_hash_table table;
+    const auto hash = [](int k) { return static_cast<size_t>(k % 7); };
+    const auto equal = [&](int k) {
+        return [&keys, k](vertex_id id) { return keys[id] == k; };
+    };
+    for (int k = 0; k < 100; ++k) {
+        REQUIRE(table.insert(hash(k), equal(k)).second);
+        keys.push_back(k);
+    }
+    for (int k = 0; k < 100; k += 3) {
+        REQUIRE(table.erase(hash(k), equal(k)));
+        REQUIRE(!table.erase(hash(k), equal(k)));
+    }
+    for (int k = 0; k < 100; ++k) {
+        const auto id = table.find(hash(k), equal(k));
+        REQUIRE(id == (k % 3 == 0 ? invalid_vertex : vertex_id(k)));
+    }
+    // erased ids stay allocated, a key inserted again gets a new id
+    REQUIRE(table.size() == 100);
+    REQUIRE(table.insert(hash(3), equal(3))
+        == std::make_pair(vertex_id(100), true));
+    keys.push_back(3);
+    table.reserve(1000);
+    REQUIRE(table.find(hash(3), equal(3)) == vertex_id(100));
+    REQUIRE(table.find(hash(4), equal(4)) == vertex_id(4));
+    REQUIRE(table.find(hash(6), equal(6)) == invalid_vertex);
+}
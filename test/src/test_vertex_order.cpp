@@ -0,0 +1,107 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <graph_storage.h>
+#include <job_graph.h>
+#include <vertex_order.h>
+
+#include "test_graphs.h"
+
+using namespace std::literals;
+
+using namespace job_sheduler;
+
+using test_utils::create_reference_graph;
+
+namespace {
+
+// random dag with edges in random order, so ids of first appearance are
+// unrelated to the levels
+std::vector<std::pair<int, int>> create_random_edges(
+    int num_vertices, int num_edges)
+{
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int> vertex(0, num_vertices - 1);
+    std::vector<std::pair<int, int>> res;
+    while (static_cast<int>(res.size()) < num_edges) {
+        const auto from = vertex(gen);
+        const auto to = vertex(gen);
+        if (from != to) {
+            res.emplace_back(std::min(from, to), std::max(from, to));
+        }
+    }
+    return res;
+}
+
+} // namespace
+
+TEST_CASE("level order lists the vertices level by level",
+    "[vertex_order]")
+{
+    const auto graph = create_reference_graph();
+    std::vector<std::string> labels;
+    for (auto id : level_order(graph)) {
+        labels.push_back(graph.vertex_at(id));
+    }
+    REQUIRE(labels
+        == std::vector<std::string>{
+               "a", "b", "g", "c", "d", "h", "i", "e", "j", "f" });
+}
+
+TEST_CASE("reordered graphs have the same schedule", "[vertex_order]")
+{
+    auto graph = create_reference_graph();
+    auto reordered = reorder_by_level(graph);
+    REQUIRE(reordered.num_vertices() == graph.num_vertices());
+    REQUIRE(reordered.num_edges() == graph.num_edges());
+    REQUIRE(*reordered.id_of("b") == 1);
+    REQUIRE(*reordered.id_of("f") == 9);
+    REQUIRE(reordered.get_full_schedule() == graph.get_full_schedule());
+
+    const auto edges = create_random_edges(2000, 10000);
+    auto random = make_graph<csr_storage>(edges.cbegin(), edges.cend());
+    auto reordered_random = reorder_by_level(random);
+    // the ids of a level are consecutive
+    vertex_id next = 0;
+    auto copy = reordered_random;
+    while (!copy.is_done()) {
+        for (auto id : copy.next_level()) {
+            REQUIRE(id == next++);
+        }
+    }
+    REQUIRE(reordered_random.get_full_schedule()
+        == random.get_full_schedule());
+}
+
+TEST_CASE("reordering drops removed vertices", "[vertex_order]")
+{
+    auto graph = create_reference_graph();
+    graph.remove_vertex("h");
+    graph.remove_vertex("a");
+    auto reordered = reorder_by_level(graph);
+    REQUIRE(reordered.storage().size() == 8);
+    REQUIRE(!reordered.id_of("h"));
+    REQUIRE(reordered.num_edges() == graph.num_edges());
+    // the entry points of a modified graph are in the order of their ids
+    REQUIRE(reordered.get_full_schedule()
+        == std::vector<std::vector<std::string>>{ { "g", "b" },
+               { "i", "c", "d" }, { "j", "e" }, { "f" } });
+    REQUIRE(graph.get_full_schedule().size() == 4);
+}
+
+TEST_CASE("reordering keeps cycles", "[vertex_order]")
+{
+    auto graph = make_graph({ std::make_pair("a"s, "b"s),
+        std::make_pair("c"s, "b"s), std::make_pair("b"s, "c"s),
+        std::make_pair("a"s, "d"s) });
+    auto reordered = reorder_by_level(graph);
+    REQUIRE(reordered.storage().size() == 4);
+    REQUIRE(reordered.num_edges() == 4);
+    REQUIRE(reordered.next_schedule() == std::vector<std::string>{ "a" });
+    REQUIRE_THROWS(reordered.next_schedule());
+}